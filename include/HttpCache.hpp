@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/// @brief response bodies of get requests kept in the data path, so they survive a restart and can be revalidated instead of downloaded again
+namespace BeatSaver::HttpCache {
+    /// @brief a stored response body
+    struct Entry {
+        /// @brief when the body was last confirmed to be current, either by downloading it or by a 304
+        std::chrono::system_clock::time_point validatedAt;
+        /// @brief when the body was downloaded, 304s don't change this
+        std::chrono::system_clock::time_point storedAt;
+        std::vector<uint8_t> data;
+    };
+
+    /// @brief get the stored body for the request key and mark it as recently used. nullopt if the cache is disabled or doesn't have it
+    std::optional<Entry> Find(std::string const& key);
+
+    /// @brief stores the body for the request key as validated now, evicting the least recently used entries if the budget is exceeded
+    void Store(std::string const& key, std::span<uint8_t const> data);
+
+    /// @brief marks the stored body for the request key as validated now, after the server answered that it didn't change
+    void Touch(std::string const& key);
+
+    /// @brief the If-Modified-Since value to revalidate an entry with
+    /// @return nullopt if the entry was revalidated by 304s for too long and the body should be downloaded again
+    std::optional<std::string> GetIfModifiedSince(Entry const& entry);
+}
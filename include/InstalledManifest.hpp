@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/// @brief manifest of the maps installed by beatsaverplusplus, kept in the data path so installed versions can be found without scanning the output dir
+namespace BeatSaver::InstalledManifest {
+    /// @brief a map version that was installed
+    struct Entry {
+        std::string key;
+        std::string hash;
+        std::filesystem::path folder;
+        /// @brief combined size of the extracted files in bytes
+        uintmax_t size;
+    };
+
+    /// @brief get the installed entry for the hash. entries whose folder no longer exists are dropped and not returned
+    std::optional<Entry> Find(std::string_view hash);
+
+    /// @brief records an installed map, replacing whatever was recorded for its hash or folder before
+    void Add(Entry entry);
+
+    /// @brief adds up the size of the files in a map folder, to record with Add
+    uintmax_t GetFolderSize(std::filesystem::path const& folder);
+}
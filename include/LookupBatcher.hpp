@@ -0,0 +1,77 @@
+#pragma once
+
+#include "BeatSaver.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BeatSaver::API {
+    /// @brief collects single lookups that arrive within a short window and fetches them with one batch request
+    template<typename Id, typename Result>
+    class LookupBatcher {
+        public:
+            /// @param fetch gets the results for a batch of distinct ids, in the same order as the ids. runs on the executor, on its timer thread when the window ran out
+            /// @param window how long the first lookup of a batch waits for others to join it
+            LookupBatcher(std::function<std::vector<Result>(std::vector<Id> const&)> fetch, std::function<std::chrono::milliseconds()> window) : fetch(std::move(fetch)), window(std::move(window)) {}
+
+            /// @brief queues a lookup, onFinished is called with its result once the batch it ended up in is done
+            void Load(Id id, std::function<void(Result)> onFinished) {
+                std::unique_lock lock(mutex);
+                pending.emplace_back(std::move(id), std::move(onFinished));
+
+                // a full batch ends the window early, its timer finds a different batch pending and leaves that one alone
+                if (pending.size() >= MaxBatchSize) {
+                    Batch batch = std::move(pending);
+                    pending.clear();
+                    lock.unlock();
+                    Executor::GetInstance().Post([this, batch = std::move(batch)]() { Resolve(batch); });
+                    return;
+                }
+
+                // the first lookup starts the window
+                if (pending.size() == 1) {
+                    auto batchNumber = ++currentBatch;
+                    lock.unlock();
+                    Executor::GetInstance().PostDelayed(window(), [this, batchNumber]() { Flush(batchNumber); });
+                }
+            }
+        private:
+            using Batch = std::vector<std::pair<Id, std::function<void(Result)>>>;
+
+            /// @brief resolves the pending batch when its window is over, unless it was sent off full already
+            void Flush(uint64_t batchNumber) {
+                std::unique_lock lock(mutex);
+                if (batchNumber != currentBatch || pending.empty()) return;
+                Batch batch = std::move(pending);
+                pending.clear();
+                lock.unlock();
+                Resolve(batch);
+            }
+
+            void Resolve(Batch const& batch) {
+                std::vector<Id> ids;
+                std::unordered_map<Id, std::size_t> indices;
+                for (auto const& [id, _] : batch) {
+                    if (indices.emplace(id, ids.size()).second) ids.emplace_back(id);
+                }
+
+                auto results = fetch(ids);
+                for (auto const& [id, onFinished] : batch) {
+                    if (onFinished) onFinished(results[indices[id]]);
+                }
+            }
+
+            std::function<std::vector<Result>(std::vector<Id> const&)> fetch;
+            std::function<std::chrono::milliseconds()> window;
+
+            std::mutex mutex;
+            Batch pending;
+            // counts the batches started, so a window timer can tell whether the pending batch is still the one it was set for
+            uint64_t currentBatch = 0;
+    };
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace BeatSaver::Utils {
+    /// @brief thread safe map that keeps the most recently used entries within a byte budget, entries can also expire on their own
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    class LruCache {
+        public:
+            using clock = std::chrono::steady_clock;
+
+            /// @param budget combined size of the entries in bytes, 0 keeps nothing
+            explicit LruCache(std::size_t budget = 0) : budget(budget) {}
+
+            /// @brief get the value for key and mark it as recently used, nullopt if there is none or it expired
+            std::optional<Value> Find(Key const& key) {
+                std::unique_lock lock(mutex);
+                auto itr = entries.find(key);
+                if (itr == entries.end()) return std::nullopt;
+
+                if (itr->second->expiry <= clock::now()) {
+                    Erase(itr);
+                    return std::nullopt;
+                }
+
+                order.splice(order.begin(), order, itr->second);
+                return itr->second->value;
+            }
+
+            /// @brief adds or replaces the value for key, evicting the least recently used entries to stay within the budget
+            /// @param size what the entry counts for against the budget, an entry bigger than the whole budget isn't kept
+            /// @param expiry when the entry stops being returned
+            void Insert(Key key, Value value, std::size_t size, clock::time_point expiry = clock::time_point::max()) {
+                std::unique_lock lock(mutex);
+                if (auto itr = entries.find(key); itr != entries.end()) Erase(itr);
+                if (size > budget) return;
+
+                order.push_front(Entry{key, std::move(value), size, expiry});
+                entries.emplace(std::move(key), order.begin());
+                used += size;
+                Evict();
+            }
+
+            /// @brief removes the entry for key if there is one
+            void Remove(Key const& key) {
+                std::unique_lock lock(mutex);
+                if (auto itr = entries.find(key); itr != entries.end()) Erase(itr);
+            }
+
+            void Clear() {
+                std::unique_lock lock(mutex);
+                entries.clear();
+                order.clear();
+                used = 0;
+            }
+
+            /// @brief changes the budget, evicting right away if the entries don't fit anymore
+            void SetBudget(std::size_t budget) {
+                std::unique_lock lock(mutex);
+                this->budget = budget;
+                Evict();
+            }
+
+            std::size_t GetBudget() {
+                std::unique_lock lock(mutex);
+                return budget;
+            }
+
+            /// @brief combined size of the entries kept right now
+            std::size_t GetSize() {
+                std::unique_lock lock(mutex);
+                return used;
+            }
+        private:
+            struct Entry {
+                Key key;
+                Value value;
+                std::size_t size;
+                clock::time_point expiry;
+            };
+            using Order = std::list<Entry>;
+
+            /// @brief expects mutex to be held
+            void Erase(typename std::unordered_map<Key, typename Order::iterator, Hash>::iterator itr) {
+                used -= itr->second->size;
+                order.erase(itr->second);
+                entries.erase(itr);
+            }
+
+            /// @brief drops entries from the back until the rest fits, expects mutex to be held
+            void Evict() {
+                while (used > budget && !order.empty()) {
+                    auto itr = entries.find(order.back().key);
+                    Erase(itr);
+                }
+            }
+
+            std::mutex mutex;
+            std::size_t budget;
+            std::size_t used = 0;
+            Order order;
+            std::unordered_map<Key, typename Order::iterator, Hash> entries;
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "BeatSaver.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+
+namespace BeatSaver::API {
+    /// @brief token bucket that backs off when the server says it's being rate limited, and recovers as requests go through again
+    class TokenBucket {
+        public:
+            explicit TokenBucket(RateLimit limit);
+
+            /// @brief waits for a token and takes it
+            /// @return false if stop was requested first
+            bool Acquire(std::stop_token stopToken);
+
+            /// @brief adapts the rate to how a request went
+            void Report(long httpCode, int curlStatus);
+
+            void SetLimit(RateLimit limit);
+            RateLimit GetLimit();
+        private:
+            using clock = std::chrono::steady_clock;
+
+            /// @brief adds the tokens earned since the last refill, expects mutex to be held
+            void Refill(clock::time_point now);
+
+            std::mutex mutex;
+            std::condition_variable_any changed;
+            RateLimit limit;
+            /// @brief the adapted rate, at most limit.requestsPerSecond
+            double rate;
+            double tokens;
+            clock::time_point lastRefill;
+            clock::time_point pausedUntil;
+    };
+}
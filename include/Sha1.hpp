@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace BeatSaver::Utils {
+    /// @brief incremental sha1, used to compute beatsaver map hashes while the files are being extracted
+    class Sha1 {
+        public:
+            Sha1();
+
+            /// @brief feed more data into the hash
+            void Update(std::span<uint8_t const> data);
+
+            /// @brief finish the hash and get it as a lowercase hex string, the instance should not be updated afterwards
+            std::string HexDigest();
+        private:
+            void ProcessBlock(uint8_t const* block);
+
+            std::array<uint32_t, 5> state;
+            std::array<uint8_t, 64> buffer;
+            std::size_t bufferSize = 0;
+            uint64_t totalSize = 0;
+    };
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BeatSaver::Utils {
+    /// @brief runs work at most once per key at a time. callers asking for a key that is already in flight wait for that result instead of doing the work again
+    template<typename T>
+    class SingleFlight {
+        public:
+            /// @brief runs work for key, or joins the run that is already in flight for it. a run that was asked to stop because every caller left isn't joined, a new one starts instead
+            /// @param progressReport called with the progress of whichever run ends up producing the result, until stop is requested
+            /// @param stopToken when stop is requested a caller that joined stops waiting. the work itself is only asked to stop once every caller sharing it did
+            /// @param work gets a progress function that reports to every caller sharing the run, and a stop token for when nobody wants the result anymore
+            /// @return the result, nullopt if stop was requested before it was there. the caller running the work always gets the result
+            std::optional<T> Run(std::string const& key, std::function<void(float)> progressReport, std::stop_token stopToken, std::function<T(std::function<void(float)>, std::stop_token)> const& work) {
+                std::shared_ptr<Call> call;
+                std::shared_ptr<Call> stopped;
+                bool leader = false;
+                uint64_t listenerId;
+                {
+                    std::unique_lock lock(callsMutex);
+                    std::unique_lock<std::mutex> callLock;
+                    auto itr = calls.find(key);
+                    if (itr != calls.end()) {
+                        callLock = std::unique_lock(itr->second->mutex);
+                        // every caller of that run left and it was asked to stop, joining it would only get its cancelled result
+                        if (!itr->second->stopSource.stop_requested()) call = itr->second;
+                        else stopped = itr->second;
+                        callLock.unlock();
+                        if (call) callLock = std::unique_lock(call->mutex);
+                    }
+                    if (!call) {
+                        call = std::make_shared<Call>();
+                        calls.insert_or_assign(key, call);
+                        leader = true;
+                        callLock = std::unique_lock(call->mutex);
+                    }
+
+                    call->participants++;
+                    listenerId = call->nextListenerId++;
+                    if (progressReport) call->progressListeners.emplace_back(listenerId, std::move(progressReport));
+                }
+
+                // a caller that stops doesn't want progress anymore, and the work stops once nobody is left
+                std::stop_callback onStop(stopToken, [call, listenerId]() {
+                    std::unique_lock callLock(call->mutex);
+                    std::erase_if(call->progressListeners, [listenerId](auto const& listener) { return listener.first == listenerId; });
+                    if (--call->participants == 0) call->stopSource.request_stop();
+                    call->finished.notify_all();
+                });
+
+                if (leader) {
+                    auto broadcastProgress = [call](float progress) {
+                        decltype(call->progressListeners) listeners;
+                        {
+                            std::unique_lock callLock(call->mutex);
+                            listeners = call->progressListeners;
+                        }
+                        for (auto& [_, listener] : listeners) listener(progress);
+                    };
+
+                    if (stopped) {
+                        // the stopped run may still be finishing its transfer or writing the same files, so the new one starts after it's done
+                        std::unique_lock stoppedLock(stopped->mutex);
+                        stopped->finished.wait(stoppedLock, call->stopSource.get_token(), [&stopped]() { return stopped->done; });
+                    }
+
+                    try {
+                        auto result = work(broadcastProgress, call->stopSource.get_token());
+                        Finish(key, call, result, nullptr);
+                        return result;
+                    } catch (...) {
+                        // the callers that joined get the same exception instead of waiting forever
+                        Finish(key, call, std::nullopt, std::current_exception());
+                        throw;
+                    }
+                }
+
+                std::unique_lock callLock(call->mutex);
+                call->finished.wait(callLock, stopToken, [&call]() { return call->done; });
+                if (!call->done) return std::nullopt;
+                if (call->exception) std::rethrow_exception(call->exception);
+                return call->result;
+            }
+        private:
+            struct Call {
+                std::mutex mutex;
+                std::condition_variable_any finished;
+                bool done = false;
+                std::optional<T> result = std::nullopt;
+                std::exception_ptr exception = nullptr;
+                int participants = 0;
+                std::stop_source stopSource;
+                uint64_t nextListenerId = 0;
+                std::vector<std::pair<uint64_t, std::function<void(float)>>> progressListeners;
+            };
+
+            void Finish(std::string const& key, std::shared_ptr<Call> const& call, std::optional<T> result, std::exception_ptr exception) {
+                {
+                    std::unique_lock lock(callsMutex);
+                    // a stopped run may have been replaced by a fresh one for the same key already
+                    auto itr = calls.find(key);
+                    if (itr != calls.end() && itr->second == call) calls.erase(itr);
+                }
+
+                std::unique_lock callLock(call->mutex);
+                call->result = std::move(result);
+                call->exception = exception;
+                call->done = true;
+                call->finished.notify_all();
+            }
+
+            std::mutex callsMutex;
+            std::unordered_map<std::string, std::shared_ptr<Call>> calls;
+    };
+}
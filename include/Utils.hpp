@@ -1,13 +1,39 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <filesystem>
+#include <optional>
 #include <ranges>
+#include <span>
+#include <stop_token>
+#include <vector>
+
+namespace WebUtils {
+    struct URLOptions;
+}
 
 namespace BeatSaver::Utils {
     std::string ReplaceIllegalCharsInPath(std::string path);
 
-    bool ExtractAll(std::span<uint8_t const> zipData, std::filesystem::path const& outputPath);
+    /// @brief extracts the zip data into outputPath, on failure everything it extracted is removed again
+    /// @param expectedHash if not empty, the beatsaver map hash is computed from the extracted bytes and false is returned if it doesn't match
+    bool ExtractAll(std::span<uint8_t const> zipData, std::filesystem::path const& outputPath, std::string_view expectedHash = {});
+
+    /// @brief extracts the zip at zipPath, libzip reads it from disk on demand so the archive is never fully loaded into memory, on failure everything it extracted is removed again
+    /// @param expectedHash if not empty, the beatsaver map hash is computed from the extracted bytes and false is returned if it doesn't match
+    bool ExtractAll(std::filesystem::path const& zipPath, std::filesystem::path const& outputPath, std::string_view expectedHash = {});
+
+    /// @brief moves a directory to a new location, replacing whatever was there. falls back to copying when a rename isn't possible, what was there is put back if neither works
+    bool MoveDirectory(std::filesystem::path const& from, std::filesystem::path const& to);
+
+    /// @brief key that identical requests share, the url, queries and headers in a canonical order
+    std::string GetRequestKey(WebUtils::URLOptions const& urlOptions);
+
+    /// @brief gets the data at the url, nullopt if it failed or stop was requested first
+    std::optional<std::vector<uint8_t>> GetData(std::string dataURL, std::stop_token stopToken = {});
 
-    std::optional<std::vector<uint8_t>> GetData(std::string dataURL);
+    /// @brief gets a cover, preview or avatar through the asset cache, nullopt if it failed or stop was requested first
+    /// @param hash map hash the asset belongs to, empty if it doesn't belong to a map
+    std::optional<std::vector<uint8_t>> GetAsset(std::string assetURL, std::string_view hash = {}, std::stop_token stopToken = {});
 }
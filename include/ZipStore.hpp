@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+/// @brief content addressed store of beatmap zips in the data path, keyed by map hash so a map that was downloaded before can be installed without the network
+namespace BeatSaver::ZipStore {
+    /// @brief path of a stored zip, eviction leaves the zip alone for as long as any copy of this is around
+    using StoredZip = std::shared_ptr<std::filesystem::path const>;
+
+    /// @brief get the stored zip for the hash, marks it as recently used. nullptr if the store is disabled or doesn't have it.
+    /// keep the result until done reading the zip, so adding other zips can't evict it in the meantime
+    StoredZip Find(std::string_view hash);
+
+    /// @brief moves the zip file at zipPath into the store, evicting the least recently used zips if the budget is exceeded
+    /// @return whether the zip was taken, if false zipPath is left alone
+    bool Add(std::string_view hash, std::filesystem::path const& zipPath);
+
+    /// @brief writes the zip data into the store, evicting the least recently used zips if the budget is exceeded
+    bool Add(std::string_view hash, std::span<uint8_t const> zipData);
+
+    /// @brief removes the zip for the hash, used when a stored zip turned out to be broken. it's removed even if it was found and is still held
+    void Remove(std::string_view hash);
+
+    /// @brief gets the map hash from a cdn download url, which is named after it. nullopt if the url doesn't look like one
+    std::optional<std::string> HashFromURL(std::string_view url);
+}
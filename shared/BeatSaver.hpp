@@ -2,6 +2,8 @@
 
 #include "./_config.h"
 #include "./macros.hpp"
+#include "./Executor.hpp"
+#include "./Future.hpp"
 #include "./Models/SearchPage.hpp"
 #include "./Models/UserDetail.hpp"
 #include "./Models/VoteSummary.hpp"
@@ -15,8 +17,15 @@
 
 #include <chrono>
 #include <future>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <stop_token>
+#include <thread>
 #include <type_traits>
+#include <typeindex>
+#include <utility>
+#include <vector>
 
 #if defined(BEATSAVER_PLUSPLUS_AUTO_INIT) && __has_include("songcore/shared/SongCore.hpp")
 #include "songcore/shared/SongCore.hpp"
@@ -41,18 +50,83 @@ namespace BeatSaver::API {
     /// @brief Get the root dir where songs are saved to. defaults to the SongCore/CustomLevels directory if it was never initialized
     BEATSAVER_PLUSPLUS_EXPORT std::filesystem::path GetDefaultOutputPath();
 
-    /// @brief downloads a song zip from the url to a given path
+    /// @brief set the dir where beatsaverplusplus keeps its own files, like in progress downloads
+    BEATSAVER_PLUSPLUS_EXPORT void SetDataPath(std::filesystem::path dataPath);
+
+    /// @brief Get the dir where beatsaverplusplus keeps its own files. defaults to the Mods/BeatSaverPlusPlus directory if it was never set
+    BEATSAVER_PLUSPLUS_EXPORT std::filesystem::path GetDataPath();
+
+    /// @brief set the max amount of bytes requested at once when downloading beatmaps. downloads are written to disk chunk by chunk, so this bounds the memory used per download
+    /// @param chunkSize size of a chunk in bytes, 0 disables chunking and buffers the entire zip in memory before extracting
+    BEATSAVER_PLUSPLUS_EXPORT void SetDownloadChunkSize(std::size_t chunkSize);
+
+    /// @brief Get the max amount of bytes requested at once when downloading beatmaps. defaults to 8 MiB
+    BEATSAVER_PLUSPLUS_EXPORT std::size_t GetDownloadChunkSize();
+
+    /// @brief set how many bytes of beatmap zips may be kept in the zip store in the data path. downloaded maps are kept there by hash,
+    /// so installing a map again, or a map another mod already downloaded, doesn't hit the network. least recently used zips are evicted first
+    /// @param budget size budget in bytes, 0 disables the store
+    BEATSAVER_PLUSPLUS_EXPORT void SetZipStoreBudget(std::uintmax_t budget);
+
+    /// @brief Get how many bytes of beatmap zips may be kept in the zip store. defaults to 0, which means the store is disabled
+    BEATSAVER_PLUSPLUS_EXPORT std::uintmax_t GetZipStoreBudget();
+
+    /// @brief set how many bytes of get responses may be kept in the http cache in the data path. cached responses survive a restart and are revalidated
+    /// with If-Modified-Since, so one that didn't change costs a 304 instead of the whole body. least recently used responses are evicted first
+    /// @param budget size budget in bytes, 0 disables the cache
+    BEATSAVER_PLUSPLUS_EXPORT void SetHttpCacheBudget(std::uintmax_t budget);
+
+    /// @brief Get how many bytes of get responses may be kept in the http cache. defaults to 0, which means the cache is disabled
+    BEATSAVER_PLUSPLUS_EXPORT std::uintmax_t GetHttpCacheBudget();
+
+    /// @brief set whether downloads of a map version that is already installed are skipped. every map installed by beatsaverplusplus is recorded
+    /// in a manifest in the data path, so this is a lookup by hash, not a scan of the output dir. skipped downloads return the folder the map is in
+    BEATSAVER_PLUSPLUS_EXPORT void SetSkipInstalledMaps(bool skipInstalled);
+
+    /// @brief Get whether downloads of a map version that is already installed are skipped, defaults to false
+    BEATSAVER_PLUSPLUS_EXPORT bool GetSkipInstalledMaps();
+
+    /// @brief get where the map version with this hash was installed, according to the installed map manifest
+    /// @return the map folder, nullopt if it's not installed or the folder was removed since
+    BEATSAVER_PLUSPLUS_EXPORT std::optional<std::filesystem::path> GetInstalledMapPath(std::string_view hash);
+
+    /// @brief downloads the file at the url into the given file using range requests, so at most one chunk of the file is in memory at any time
+    /// @param urlOptions the url options to download the file from
+    /// chunks that fail are retried, and if the download still fails the partial file is kept. a later call for the same url and file resumes at its end,
+    /// after checking the bytes before the resume point still match the remote file. if they don't, the download starts over.
+    /// @param filePath the file to write into, gets created, resumed or truncated. filePath + ".url" remembers which url the partial file belongs to
+    /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the download stops before the next chunk, and the partial file is kept
+    /// @return bool success, if any chunk failed to download or could not be written, false will return.
+    bool BEATSAVER_PLUSPLUS_EXPORT DownloadToFile(WebUtils::URLOptions urlOptions, std::filesystem::path filePath, std::function<void(float)> progressReport = nullptr, std::stop_token stopToken = {});
+
+    /// @brief downloads a song zip from the url to a given path. a cdn url named after the map hash is checked against that hash while extracting, the map only lands in the path once all of it checked out
     /// @param urlOptions the url options to download the file from
     /// @param outputPath the output directory, should not be CustomLevels, but the output path
+    /// @param stopToken when stop is requested the download is dropped if it hasn't started yet, and nothing gets extracted
     /// @return bool future success, if download failed or extraction of the file failed, false will return.
-    std::future<bool> BEATSAVER_PLUSPLUS_EXPORT DownloadSongZipAsync(WebUtils::URLOptions urlOptions, std::filesystem::path outputPath, std::function<void(float)> progressReport = nullptr);
+    Future<bool> BEATSAVER_PLUSPLUS_EXPORT DownloadSongZipAsync(WebUtils::URLOptions urlOptions, std::filesystem::path outputPath, std::function<void(float)> progressReport = nullptr, std::stop_token stopToken = {});
 
-    /// @brief downloads a song zip from the url to a given path
+    /// @brief downloads a song zip from the url to a given path. a cdn url named after the map hash is checked against that hash while extracting, the map only lands in the path once all of it checked out
     /// @param urlOptions the url options to download the file from
     /// @param outputPath the output directory, should not be CustomLevels, but the output path
+    /// @param stopToken when stop is requested the caller stops waiting for the download, and nothing gets extracted unless another caller shares it
     /// @return bool success, if download failed or extraction of the file failed, false will return.
-    bool BEATSAVER_PLUSPLUS_EXPORT DownloadSongZip(WebUtils::URLOptions urlOptions, std::filesystem::path outputPath, std::function<void(float)> progressReport = nullptr);
+    bool BEATSAVER_PLUSPLUS_EXPORT DownloadSongZip(WebUtils::URLOptions urlOptions, std::filesystem::path outputPath, std::function<void(float)> progressReport = nullptr, std::stop_token stopToken = {});
 #pragma region responses
+    /// @brief most ids one batch lookup request can take, the batch endpoints split bigger batches into chunks of at most this many
+    inline constexpr std::size_t MaxBatchSize = 50;
+
+    /// @brief a chunk of a batch lookup that failed, the merged response only has the results of the other chunks
+    struct BEATSAVER_PLUSPLUS_EXPORT BatchChunkFailure {
+        /// @brief index of the chunk's first id in the requested ids
+        std::size_t offset;
+        /// @brief amount of ids in the chunk
+        std::size_t count;
+        long httpCode;
+        int curlStatus;
+    };
+
     BEATSAVER_PLUSPLUS_DECLARE_SIMPLE_RESPONSE_T(Models, SearchPage);
     BEATSAVER_PLUSPLUS_DECLARE_SIMPLE_RESPONSE_T(Models, Beatmap);
     BEATSAVER_PLUSPLUS_DECLARE_SIMPLE_RESPONSE_T(Models, UserDetail);
@@ -60,6 +134,11 @@ namespace BeatSaver::API {
     BEATSAVER_PLUSPLUS_DECLARE_SIMPLE_RESPONSE_T(Models, PlaylistPage);
 
     struct BEATSAVER_PLUSPLUS_EXPORT BeatmapMapResponse : public WebUtils::GenericResponse<std::unordered_map<std::string, Models::Beatmap>> {
+        /// @brief chunks of a batch bigger than MaxBatchSize that failed to get
+        std::vector<BatchChunkFailure> failedChunks;
+        /// @brief whether this came from a local cache because beatsaver couldn't be reached, it may be out of date
+        bool stale = false;
+
         bool AcceptData(std::span<uint8_t const> data) override {
             rapidjson::Document doc;
             doc.Parse((char*)data.data(), data.size());
@@ -92,6 +171,11 @@ namespace BeatSaver::API {
     };
 
     struct BEATSAVER_PLUSPLUS_EXPORT UserDetailArrayResponse : public WebUtils::GenericResponse<std::vector<Models::UserDetail>> {
+        /// @brief chunks of a batch bigger than MaxBatchSize that failed to get
+        std::vector<BatchChunkFailure> failedChunks;
+        /// @brief whether this came from a local cache because beatsaver couldn't be reached, it may be out of date
+        bool stale = false;
+
         bool AcceptData(std::span<uint8_t const> data) override {
             rapidjson::Document doc;
             doc.Parse((char*)data.data(), data.size());
@@ -147,6 +231,9 @@ namespace BeatSaver::API {
     using VoteResponse = VerifyResponse;
 
     struct BEATSAVER_PLUSPLUS_EXPORT ListOfVoteSummaryResponse : public WebUtils::GenericResponse<std::vector<Models::VoteSummary>> {
+        /// @brief whether this came from a local cache because beatsaver couldn't be reached, it may be out of date
+        bool stale = false;
+
         bool AcceptData(std::span<uint8_t const> data) override {
             rapidjson::Document doc;
             doc.Parse((char*)data.data(), data.size());
@@ -194,6 +281,696 @@ namespace BeatSaver::API {
 
 #define DECLARE_BEATSAVER_RESPONSE_T(func, ...) template<> struct BEATSAVER_PLUSPLUS_EXPORT BeatSaverResponse<&func> { using t = __VA_ARGS__; }
 
+#pragma region requests
+    /// @brief the unparsed result of a get request made through beatsaverplusplus
+    struct BEATSAVER_PLUSPLUS_EXPORT RawResponse {
+        long httpCode = 0;
+        int curlStatus = 0;
+        std::optional<std::vector<uint8_t>> data = std::nullopt;
+        /// @brief whether this came from the http cache because beatsaver couldn't be reached, it may be out of date
+        bool stale = false;
+    };
+
+    /// @brief decides how failed requests are retried. every get, post and download chunk beatsaverplusplus makes goes through it
+    struct BEATSAVER_PLUSPLUS_EXPORT RetryPolicy {
+        /// @brief attempts per request including the first one, 1 disables retrying
+        int maxAttempts = 4;
+        /// @brief delay before the first retry, doubled for every following retry. the actual delay is randomized between 0 and this, so clients don't retry in lockstep
+        std::chrono::milliseconds baseDelay{250};
+        /// @brief cap on the doubled delay
+        std::chrono::milliseconds maxDelay{8000};
+        /// @brief minimum delay after a 429 or 503. webutils doesn't expose response headers, so this stands in for Retry-After
+        std::chrono::milliseconds rateLimitedDelay{2000};
+        /// @brief no retry gets started if it would begin later than this after the first attempt, 0 means no budget
+        std::chrono::milliseconds timeBudget{30000};
+        /// @brief decides whether a failed attempt is worth retrying, nullptr uses IsRetryableFailure
+        std::function<bool(long httpCode, int curlStatus)> isRetryable = nullptr;
+
+        /// @brief get the delay before the given retry
+        /// @param retry 1 for the first retry
+        /// @param httpCode the http code of the attempt that failed
+        std::chrono::milliseconds GetDelay(int retry, long httpCode) const;
+    };
+
+    /// @brief default classification of failed attempts: connection problems, timeouts, 408, 425, 429 and 5xx other than 501 are retryable. other 4xx and bad urls are not
+    BEATSAVER_PLUSPLUS_EXPORT bool IsRetryableFailure(long httpCode, int curlStatus);
+
+    /// @brief set the retry policy used for every request from now on
+    BEATSAVER_PLUSPLUS_EXPORT void SetRetryPolicy(RetryPolicy policy);
+
+    /// @brief get the retry policy used for every request
+    BEATSAVER_PLUSPLUS_EXPORT RetryPolicy GetRetryPolicy();
+
+    /// @brief calls request until it succeeds, fails in a way that isn't retryable, or the retry policy gives up. waits between attempts as the policy says
+    /// @param request performs one attempt and returns its http code and curl status
+    /// @param stopToken when stop is requested no more attempts are made, and a running delay is cut short
+    BEATSAVER_PLUSPLUS_EXPORT void RetryRequest(std::function<std::pair<long, int>()> const& request, std::stop_token stopToken = {});
+
+    /// @brief the rate limit buckets requests are split over, api requests and file downloads are limited separately by the server
+    enum class BEATSAVER_PLUSPLUS_EXPORT RateLimitBucket {
+        /// @brief requests to BEATSAVER_API_URL
+        API,
+        /// @brief everything else, zips, covers, previews and avatars
+        CDN
+    };
+
+    /// @brief token bucket settings for one rate limit bucket
+    struct BEATSAVER_PLUSPLUS_EXPORT RateLimit {
+        /// @brief requests started per second on average, 0 disables limiting for the bucket
+        double requestsPerSecond = 0;
+        /// @brief requests that may start at once after being idle
+        int burst = 1;
+        /// @brief how long the bucket lets nothing through after a 429 or 503. webutils doesn't expose response headers, so this stands in for the rate limit headers
+        std::chrono::milliseconds cooldown{1000};
+    };
+
+    /// @brief set the limit for a bucket. every get, post and download chunk of the process waits for a token of its bucket, so separate mods share the limit.
+    /// after a 429 or 503 the bucket halves its rate and pauses for the cooldown, every successful request then wins back a bit of the configured rate
+    BEATSAVER_PLUSPLUS_EXPORT void SetRateLimit(RateLimitBucket bucket, RateLimit limit);
+
+    /// @brief get the limit set for a bucket. limiting is opt in, both buckets default to 0 requests per second which disables them
+    BEATSAVER_PLUSPLUS_EXPORT RateLimit GetRateLimit(RateLimitBucket bucket);
+
+    /// @brief get the bucket requests to the url are limited by
+    BEATSAVER_PLUSPLUS_EXPORT RateLimitBucket GetRateLimitBucket(std::string_view url);
+
+    /// @brief waits until the bucket of the url lets another request start
+    /// @param stopToken stops waiting
+    /// @return false if stop was requested first, the request shouldn't be made then
+    BEATSAVER_PLUSPLUS_EXPORT bool AcquireRequestSlot(std::string_view url, std::stop_token stopToken = {});
+
+    /// @brief tells the bucket of the url how a request went, which is what it adapts its rate from. the offline detection is told as well
+    BEATSAVER_PLUSPLUS_EXPORT void ReportRequestResult(std::string_view url, long httpCode, int curlStatus);
+
+    /// @brief curl status responses get when stop was requested before they finished, the same as CURLE_ABORTED_BY_CALLBACK
+    inline constexpr int CancelledCurlStatus = 42;
+
+    /// @brief curl status requests get when they weren't made because beatsaver is considered unreachable, the same as CURLE_COULDNT_CONNECT
+    inline constexpr int OfflineCurlStatus = 7;
+
+    enum class BEATSAVER_PLUSPLUS_EXPORT OfflineMode {
+        /// @brief every request goes to the network
+        Disabled,
+        /// @brief after connection failures in a row, requests aren't made for the probe interval. then one request checks whether beatsaver is back while the rest stay short-circuited
+        Automatic,
+        /// @brief no request goes to the network
+        Forced
+    };
+
+    /// @brief set whether requests are short-circuited while beatsaver can't be reached. short-circuited and failed gets are answered from the http cache
+    /// and the responses kept for stale while revalidate, marked as stale, and retries stop right away instead of waiting out the retry policy
+    BEATSAVER_PLUSPLUS_EXPORT void SetOfflineMode(OfflineMode mode);
+
+    /// @brief get whether requests are short-circuited while beatsaver can't be reached, defaults to Disabled
+    BEATSAVER_PLUSPLUS_EXPORT OfflineMode GetOfflineMode();
+
+    /// @brief set how long requests are short-circuited after beatsaver was found unreachable, before a request checks again
+    BEATSAVER_PLUSPLUS_EXPORT void SetOfflineProbeInterval(std::chrono::milliseconds interval);
+
+    /// @brief get how long requests are short-circuited after beatsaver was found unreachable, defaults to 15 seconds
+    BEATSAVER_PLUSPLUS_EXPORT std::chrono::milliseconds GetOfflineProbeInterval();
+
+    /// @brief whether requests are short-circuited right now, because the offline mode is forced or beatsaver was found unreachable
+    BEATSAVER_PLUSPLUS_EXPORT bool IsOffline();
+
+    namespace Detail {
+        /// @brief whether a failed request means beatsaver couldn't be reached, connection problems and timeouts, or a gateway error in front of the api
+        BEATSAVER_PLUSPLUS_EXPORT bool IsConnectivityFailure(long httpCode, int curlStatus);
+
+        /// @brief whether the next request should be short-circuited. after the probe interval the first caller gets false, and is the one that checks
+        BEATSAVER_PLUSPLUS_EXPORT bool ShouldShortCircuit();
+
+        /// @brief tells the offline detection how a request went
+        BEATSAVER_PLUSPLUS_EXPORT void ReportConnectivity(long httpCode, int curlStatus);
+    }
+
+    /// @brief performs a get request with the beatsaver downloader, retrying as the retry policy says. identical requests that are in flight at the same time share a single transfer, and every caller gets its result
+    /// @param urlOptions the url options to request
+    /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the caller gets a cancelled response right away. a running transfer finishes in the background, it is only retried while some other caller still wants it
+    /// @return the shared raw response, never nullptr. its curlStatus is CancelledCurlStatus if stop was requested first
+    BEATSAVER_PLUSPLUS_EXPORT std::shared_ptr<RawResponse const> FetchRaw(WebUtils::URLOptions const& urlOptions, progress_function progressReport = nullptr, std::stop_token stopToken = {});
+
+    /// @brief parses a raw response into a webutils response type
+    template<typename T>
+    requires(std::is_base_of_v<WebUtils::IResponse, T>)
+    T ParseRawResponse(RawResponse const& raw) {
+        T response;
+        response.HttpCode = raw.httpCode;
+        response.CurlStatus = raw.curlStatus;
+        if (raw.data.has_value()) response.AcceptData(raw.data.value());
+        if constexpr (requires { response.stale; }) response.stale = raw.stale;
+        return response;
+    }
+
+    /// @brief set how many bytes of parsed responses are kept in memory, so asking for the same thing again within its ttl skips the network and the json parsing.
+    /// entries count for the size of the json they were parsed from, least recently used ones are evicted first
+    /// @param budget size budget in bytes, 0 disables the cache and drops whatever it held
+    BEATSAVER_PLUSPLUS_EXPORT void SetResponseCacheBudget(std::size_t budget);
+
+    /// @brief get how many bytes of parsed responses are kept in memory. defaults to 0, which means the cache is disabled
+    BEATSAVER_PLUSPLUS_EXPORT std::size_t GetResponseCacheBudget();
+
+    /// @brief set how long responses for urls starting with urlPrefix stay cached, the longest matching prefix wins
+    /// @param urlPrefix start of the url, like BEATSAVER_API_URL "/maps/id"
+    /// @param ttl how long a response is returned from the cache, 0 never caches them
+    BEATSAVER_PLUSPLUS_EXPORT void SetResponseCacheTTL(std::string urlPrefix, std::chrono::milliseconds ttl);
+
+    /// @brief get how long a response for the url stays cached. single map and user lookups default to 5 minutes, playlists and user listings to a minute,
+    /// other api requests to 30 seconds, and anything outside the api isn't cached here
+    BEATSAVER_PLUSPLUS_EXPORT std::chrono::milliseconds GetResponseCacheTTL(std::string_view url);
+
+    /// @brief drops every cached response
+    BEATSAVER_PLUSPLUS_EXPORT void ClearResponseCache();
+
+    namespace Detail {
+        /// @brief the parsed response of the given type cached for the request, nullptr if there is none
+        BEATSAVER_PLUSPLUS_EXPORT std::shared_ptr<void const> FindCachedResponse(std::type_index type, WebUtils::URLOptions const& urlOptions);
+
+        /// @brief caches a parsed response for the request with the ttl of its url
+        /// @param size size of the json it was parsed from
+        BEATSAVER_PLUSPLUS_EXPORT void StoreCachedResponse(std::type_index type, WebUtils::URLOptions const& urlOptions, std::shared_ptr<void const> response, std::size_t size);
+    }
+
+    /// @brief set how long map keys, map hashes and users that the api doesn't know are remembered as missing. asking for them again within the ttl answers a 404
+    /// without a request, and batch lookups leave them out of the ids they send. they are remembered from 404s of single lookups and ids a batch didn't return
+    /// @param ttl how long an id is remembered, 0 disables the negative cache and forgets every id
+    BEATSAVER_PLUSPLUS_EXPORT void SetNegativeCacheTTL(std::chrono::milliseconds ttl);
+
+    /// @brief get how long missing ids are remembered. defaults to 0, which means the negative cache is disabled
+    BEATSAVER_PLUSPLUS_EXPORT std::chrono::milliseconds GetNegativeCacheTTL();
+
+    /// @brief forgets every id remembered as missing, for example after uploading a map
+    BEATSAVER_PLUSPLUS_EXPORT void ClearNegativeCache();
+
+    namespace Detail {
+        /// @brief whether the request is a map or user lookup of only ids that are remembered as missing
+        BEATSAVER_PLUSPLUS_EXPORT bool IsKnownMissing(WebUtils::URLOptions const& urlOptions);
+
+        /// @brief remembers the id of a single map or user lookup that got a 404 as missing, requests for several ids or other things are ignored
+        BEATSAVER_PLUSPLUS_EXPORT void RecordMissing(WebUtils::URLOptions const& urlOptions);
+
+        /// @brief remembers the ids of a successful batch lookup that aren't in found as missing
+        /// @param found every id the response has results under, compared case insensitively
+        BEATSAVER_PLUSPLUS_EXPORT void RecordBatchMisses(WebUtils::URLOptions const& urlOptions, std::span<std::string const> found);
+    }
+
+    /// @brief set how many bytes of responses are kept for stale while revalidate requests. unlike the response cache they're kept past their ttl,
+    /// entries count for the size of the json they were parsed from, least recently used ones are evicted first
+    /// @param budget size budget in bytes, 0 keeps nothing, so every stale while revalidate request waits for the network
+    BEATSAVER_PLUSPLUS_EXPORT void SetStaleResponseBudget(std::size_t budget);
+
+    /// @brief get how many bytes of responses are kept for stale while revalidate requests. defaults to 4 MiB
+    BEATSAVER_PLUSPLUS_EXPORT std::size_t GetStaleResponseBudget();
+
+    namespace Detail {
+        /// @brief a response kept for stale while revalidate requests
+        struct BEATSAVER_PLUSPLUS_EXPORT StaleResponse {
+            std::shared_ptr<void const> response;
+            std::chrono::steady_clock::time_point fetchedAt;
+        };
+
+        /// @brief the kept response of the given type for the request, nullopt if there is none
+        BEATSAVER_PLUSPLUS_EXPORT std::optional<StaleResponse> FindStaleResponse(std::type_index type, WebUtils::URLOptions const& urlOptions);
+
+        /// @brief keeps a response for stale while revalidate requests
+        /// @param data the json it was parsed from
+        /// @return whether data differs from what the kept response was parsed from, true if there was none
+        BEATSAVER_PLUSPLUS_EXPORT bool StoreStaleResponse(std::type_index type, WebUtils::URLOptions const& urlOptions, std::shared_ptr<void const> response, std::span<uint8_t const> data);
+    }
+
+    /// @brief get request sync, what every endpoint in this header goes through. successful responses are kept in the response cache if it is enabled,
+    /// lookups of ids the negative cache knows are missing get a 404 without a request. with an offline mode, successful responses are also kept for stale while revalidate
+    /// requests, and a request that can't reach beatsaver is answered with the kept one, marked as stale, if there is one
+    /// @return T the parsed response
+    template<typename T>
+    T Fetch(WebUtils::URLOptions urlOptions, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        bool negativeCache = GetNegativeCacheTTL().count() > 0;
+        if (negativeCache && Detail::IsKnownMissing(urlOptions)) {
+            T missing;
+            missing.HttpCode = 404;
+            if (progressReport) progressReport(1.0f);
+            return missing;
+        }
+
+        constexpr bool cacheable = std::is_copy_constructible_v<T>;
+        bool useCache = cacheable && GetResponseCacheBudget() > 0;
+        if constexpr (cacheable) {
+            if (useCache) {
+                if (auto cached = Detail::FindCachedResponse(typeid(T), urlOptions)) return *std::static_pointer_cast<T const>(cached);
+            }
+        }
+
+        auto raw = FetchRaw(urlOptions, progressReport, stopToken);
+        auto response = ParseRawResponse<T>(*raw);
+        if constexpr (cacheable) {
+            bool keepStale = GetOfflineMode() != OfflineMode::Disabled;
+            if ((useCache || keepStale) && response.IsSuccessful() && raw->data.has_value() && !raw->stale) {
+                auto shared = std::make_shared<T const>(response);
+                if (useCache) Detail::StoreCachedResponse(typeid(T), urlOptions, shared, raw->data->size());
+                if (keepStale) Detail::StoreStaleResponse(typeid(T), urlOptions, std::move(shared), raw->data.value());
+            }
+
+            if constexpr (requires { response.stale; }) {
+                if (keepStale && Detail::IsConnectivityFailure(raw->httpCode, raw->curlStatus)) {
+                    if (auto kept = Detail::FindStaleResponse(typeid(T), urlOptions)) {
+                        response = *std::static_pointer_cast<T const>(kept->response);
+                        response.stale = true;
+                        return response;
+                    }
+                }
+            }
+        }
+        if (negativeCache && raw->curlStatus == 0 && raw->httpCode == 404) Detail::RecordMissing(urlOptions);
+        return response;
+    }
+
+    /// @brief get request async
+    /// @param onFinished method called when request is done void(std::optional<T>), also when stop was requested
+    template<typename T>
+    void FetchAsync(WebUtils::URLOptions urlOptions, finished_opt_function<T> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        Executor::GetInstance().Post([urlOptions = std::move(urlOptions), onFinished = std::move(onFinished), progressReport = std::move(progressReport), stopToken]() {
+            auto response = Fetch<T>(urlOptions, progressReport, stopToken);
+            if (onFinished) onFinished(std::move(response));
+        });
+    }
+
+    /// @brief get request async
+    /// @return Future<T>
+    template<typename T>
+    Future<T> FetchAsync(WebUtils::URLOptions urlOptions, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Executor::GetInstance().Submit([urlOptions = std::move(urlOptions), progressReport = std::move(progressReport), stopToken]() {
+            return Fetch<T>(urlOptions, progressReport, stopToken);
+        });
+    }
+
+    /// @brief per call policy for listings that may be shown a bit out of date: a cached response is returned right away and refreshed in the background
+    struct BEATSAVER_PLUSPLUS_EXPORT StaleWhileRevalidate {
+        /// @brief how old a cached response may be to be returned without refreshing it, nullopt uses the response cache ttl of its url
+        std::optional<std::chrono::milliseconds> maxAge = std::nullopt;
+        /// @brief how old a cached response may be to be returned at all, older ones are fetched like there was none
+        std::chrono::milliseconds maxStale{std::chrono::hours(1)};
+    };
+
+    namespace Detail {
+        /// @brief fetches the request and keeps a successful response for stale while revalidate requests, and in the response cache if it is enabled
+        /// @return the response, and whether it differs from the one that was kept
+        template<typename T>
+        std::pair<T, bool> Revalidate(WebUtils::URLOptions const& urlOptions, progress_function progressReport, std::stop_token stopToken) {
+            auto raw = FetchRaw(urlOptions, std::move(progressReport), stopToken);
+            auto response = ParseRawResponse<T>(*raw);
+            bool changed = false;
+            if (response.IsSuccessful() && raw->data.has_value() && !raw->stale) {
+                auto shared = std::make_shared<T const>(response);
+                if (GetResponseCacheBudget() > 0) StoreCachedResponse(typeid(T), urlOptions, shared, raw->data->size());
+                changed = StoreStaleResponse(typeid(T), urlOptions, std::move(shared), raw->data.value());
+            }
+            return {std::move(response), changed};
+        }
+
+        /// @brief the kept response if the policy allows returning it, refreshing it on the executor when it's older than the policy's max age
+        /// @param onRefreshed called on the executor with the refreshed response, if it differs from the kept one
+        template<typename T>
+        std::optional<T> FindRevalidatedResponse(WebUtils::URLOptions const& urlOptions, StaleWhileRevalidate const& policy, std::function<void(T)> onRefreshed, std::stop_token stopToken) {
+            auto stale = FindStaleResponse(typeid(T), urlOptions);
+            if (!stale.has_value()) return std::nullopt;
+
+            auto age = std::chrono::steady_clock::now() - stale->fetchedAt;
+            if (age > policy.maxStale) return std::nullopt;
+
+            if (age > policy.maxAge.value_or(GetResponseCacheTTL(urlOptions.url))) {
+                // identical transfers are shared, so callers refreshing the same page at once don't all download it
+                Executor::GetInstance().Post([urlOptions, onRefreshed = std::move(onRefreshed), stopToken]() {
+                    auto [response, changed] = Revalidate<T>(urlOptions, nullptr, stopToken);
+                    if (changed && onRefreshed) onRefreshed(std::move(response));
+                });
+            }
+            return *std::static_pointer_cast<T const>(stale->response);
+        }
+    }
+
+    /// @brief get request sync with the stale while revalidate policy. a kept response is returned right away, without waiting for the network,
+    /// and refreshed in the background if it's older than the policy's max age. without one this waits for the request like Fetch
+    /// @param onRefreshed called on the executor with the refreshed response once it lands, only if it differs from the one that was returned
+    /// @param stopToken when stop is requested the caller stops waiting, and a background refresh is dropped if it hasn't started yet
+    /// @return T the kept or fetched response
+    template<typename T>
+    T FetchStaleWhileRevalidate(WebUtils::URLOptions urlOptions, StaleWhileRevalidate policy, std::function<void(T)> onRefreshed = nullptr, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (auto stale = Detail::FindRevalidatedResponse<T>(urlOptions, policy, std::move(onRefreshed), stopToken)) {
+            if (progressReport) progressReport(1.0f);
+            return std::move(stale.value());
+        }
+        return Detail::Revalidate<T>(urlOptions, std::move(progressReport), stopToken).first;
+    }
+
+    /// @brief get request async with the stale while revalidate policy, see FetchStaleWhileRevalidate. a kept response resolves the future before this returns
+    /// @return Future<T>
+    template<typename T>
+    Future<T> FetchStaleWhileRevalidateAsync(WebUtils::URLOptions urlOptions, StaleWhileRevalidate policy, std::function<void(T)> onRefreshed = nullptr, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (auto stale = Detail::FindRevalidatedResponse<T>(urlOptions, policy, std::move(onRefreshed), stopToken)) {
+            if (progressReport) progressReport(1.0f);
+            Promise<T> promise;
+            auto future = promise.GetFuture();
+            promise.SetValue(std::move(stale.value()));
+            return future;
+        }
+        return Executor::GetInstance().Submit([urlOptions = std::move(urlOptions), progressReport = std::move(progressReport), stopToken]() {
+            return Detail::Revalidate<T>(urlOptions, progressReport, stopToken).first;
+        });
+    }
+
+    /// @brief post request sync, retried as the retry policy says. while beatsaver is considered unreachable it isn't sent, and gets OfflineCurlStatus as curl status
+    /// @param stopToken when stop is requested no new attempt is started, a response that never got sent has CancelledCurlStatus as curl status
+    /// @return T the parsed response
+    template<typename T>
+    T PostData(WebUtils::URLOptions urlOptions, std::span<uint8_t const> data, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        std::optional<T> response;
+        RetryRequest([&]() {
+            if (Detail::ShouldShortCircuit()) {
+                response.emplace();
+                response->CurlStatus = OfflineCurlStatus;
+                return std::pair<long, int>(0, OfflineCurlStatus);
+            }
+            if (!AcquireRequestSlot(urlOptions.url, stopToken)) return std::pair<long, int>(0, CancelledCurlStatus);
+            response.emplace(GetBeatsaverDownloader().Post<T>(urlOptions, data, progressReport));
+            ReportRequestResult(urlOptions.url, response->HttpCode, response->CurlStatus);
+            return std::pair<long, int>(response->HttpCode, response->CurlStatus);
+        }, stopToken);
+
+        if (!response.has_value()) {
+            response.emplace();
+            response->CurlStatus = CancelledCurlStatus;
+        }
+        return std::move(response.value());
+    }
+
+    /// @brief set how many chunks of one batch lookup are requested at the same time
+    BEATSAVER_PLUSPLUS_EXPORT void SetMaxBatchConcurrency(int maxConcurrency);
+
+    /// @brief get how many chunks of one batch lookup are requested at the same time, defaults to 4
+    BEATSAVER_PLUSPLUS_EXPORT int GetMaxBatchConcurrency();
+
+    /// @brief gets every one of urlOptions, at most GetMaxBatchConcurrency at a time. the calling thread fetches chunks as well, and never waits on one that hasn't started
+    /// @param progressReport method called with the average progress over every chunk, void(float) 0-1
+    /// @return the raw responses in the same order as urlOptions
+    BEATSAVER_PLUSPLUS_EXPORT std::vector<std::shared_ptr<RawResponse const>> FetchChunks(std::vector<WebUtils::URLOptions> const& urlOptions, progress_function progressReport = nullptr, std::stop_token stopToken = {});
+
+    /// @brief hit and miss counts of the asset cache since the last reset
+    struct BEATSAVER_PLUSPLUS_EXPORT AssetCacheStats {
+        /// @brief assets served from memory
+        uint64_t memoryHits = 0;
+        /// @brief assets served from disk
+        uint64_t diskHits = 0;
+        /// @brief assets that had to be downloaded
+        uint64_t misses = 0;
+        /// @brief bytes kept in memory right now
+        std::size_t memoryBytes = 0;
+    };
+
+    /// @brief set how many bytes of covers, previews and avatars are kept in memory, least recently used ones are evicted first
+    /// @param budget size budget in bytes, 0 disables the memory tier
+    BEATSAVER_PLUSPLUS_EXPORT void SetAssetCacheMemoryBudget(std::size_t budget);
+
+    /// @brief get how many bytes of assets are kept in memory. defaults to 16 MiB
+    BEATSAVER_PLUSPLUS_EXPORT std::size_t GetAssetCacheMemoryBudget();
+
+    /// @brief set how many bytes of covers and previews may be kept in the data path. they are stored by map hash, which the cdn never reuses for different content,
+    /// so they are served from disk without asking the server again. avatars can change behind the same url, so they are only kept in memory
+    /// @param budget size budget in bytes, 0 disables the disk tier
+    BEATSAVER_PLUSPLUS_EXPORT void SetAssetCacheDiskBudget(std::uintmax_t budget);
+
+    /// @brief get how many bytes of assets may be kept in the data path. defaults to 0, which means the disk tier is disabled
+    BEATSAVER_PLUSPLUS_EXPORT std::uintmax_t GetAssetCacheDiskBudget();
+
+    /// @brief get the hit and miss counts of the asset cache
+    BEATSAVER_PLUSPLUS_EXPORT AssetCacheStats GetAssetCacheStats();
+
+    /// @brief sets the hit and miss counts of the asset cache back to 0
+    BEATSAVER_PLUSPLUS_EXPORT void ResetAssetCacheStats();
+
+    /// @brief gets a cover, preview or avatar from memory, then disk, then the network, and keeps what it downloads in the tiers that are enabled
+    /// @param hash map hash the asset belongs to, which keys the disk tier. empty keeps the asset out of the disk tier
+    /// @return the raw response, never nullptr
+    BEATSAVER_PLUSPLUS_EXPORT std::shared_ptr<RawResponse const> FetchAsset(WebUtils::URLOptions const& urlOptions, std::string_view hash = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {});
+
+    /// @brief get request for an asset sync, through the asset cache
+    /// @return T the parsed response
+    template<typename T>
+    T FetchCachedAsset(WebUtils::URLOptions urlOptions, std::string hash, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return ParseRawResponse<T>(*FetchAsset(urlOptions, hash, progressReport, stopToken));
+    }
+
+    /// @brief get request for an asset async, through the asset cache
+    /// @param onFinished method called when request is done void(std::optional<T>), also when stop was requested
+    template<typename T>
+    void FetchCachedAssetAsync(WebUtils::URLOptions urlOptions, std::string hash, finished_opt_function<T> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        Executor::GetInstance().Post([urlOptions = std::move(urlOptions), hash = std::move(hash), onFinished = std::move(onFinished), progressReport = std::move(progressReport), stopToken]() {
+            auto response = FetchCachedAsset<T>(urlOptions, hash, progressReport, stopToken);
+            if (onFinished) onFinished(std::move(response));
+        });
+    }
+
+    /// @brief get request for an asset async, through the asset cache
+    /// @return Future<T>
+    template<typename T>
+    Future<T> FetchCachedAssetAsync(WebUtils::URLOptions urlOptions, std::string hash, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Executor::GetInstance().Submit([urlOptions = std::move(urlOptions), hash = std::move(hash), progressReport = std::move(progressReport), stopToken]() {
+            return FetchCachedAsset<T>(urlOptions, hash, progressReport, stopToken);
+        });
+    }
+
+    namespace Detail {
+        template<typename K, typename V>
+        void AppendBatchData(std::unordered_map<K, V>& target, std::unordered_map<K, V>&& source) {
+            target.merge(std::move(source));
+        }
+
+        template<typename V>
+        void AppendBatchData(std::vector<V>& target, std::vector<V>&& source) {
+            target.insert(target.end(), std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+        }
+
+        /// @brief every id a map batch has results under. a batch of one is answered with a bare map that's stored under its hash, so the key and hashes count as well
+        inline std::vector<std::string> GetFoundIds(std::unordered_map<std::string, Models::Beatmap> const& maps) {
+            std::vector<std::string> found;
+            for (auto const& [id, map] : maps) {
+                found.emplace_back(id);
+                found.emplace_back(map.Id);
+                for (auto const& version : map.Versions) found.emplace_back(version.Hash);
+            }
+            return found;
+        }
+
+        inline std::vector<std::string> GetFoundIds(std::vector<Models::UserDetail> const& users) {
+            std::vector<std::string> found;
+            for (auto const& user : users) found.emplace_back(std::to_string(user.Id));
+            return found;
+        }
+
+        /// @brief remembers the ids a successful batch response doesn't have as missing, if the negative cache is enabled and knows how to read the response
+        template<typename T>
+        void RecordBatchResponseMisses(WebUtils::URLOptions const& urlOptions, T const& response) {
+            if (GetNegativeCacheTTL().count() <= 0 || !response.IsSuccessful() || !response.responseData.has_value()) return;
+            if constexpr (requires { Detail::GetFoundIds(response.responseData.value()); }) {
+                RecordBatchMisses(urlOptions, GetFoundIds(response.responseData.value()));
+            }
+        }
+
+        /// @brief FetchBatch without leaving out the ids the negative cache knows are missing
+        template<typename T, typename Item>
+        T FetchBatchChunks(std::span<Item const> items, WebUtils::URLOptions(*makeOptions)(std::span<Item const>), progress_function progressReport, std::stop_token stopToken) {
+            if (items.size() <= MaxBatchSize) {
+                auto urlOptions = makeOptions(items);
+                auto response = Fetch<T>(urlOptions, progressReport, stopToken);
+                RecordBatchResponseMisses(urlOptions, response);
+                return response;
+            }
+
+            // even chunks, so 51 ids don't end up as 50 and a lone 1, which the api answers with a bare map instead of a map of them
+            auto chunkCount = (items.size() + MaxBatchSize - 1) / MaxBatchSize;
+            std::vector<std::pair<std::size_t, std::size_t>> chunks;
+            std::vector<WebUtils::URLOptions> chunkOptions;
+            for (std::size_t i = 0; i < chunkCount; i++) {
+                auto begin = items.size() * i / chunkCount;
+                auto end = items.size() * (i + 1) / chunkCount;
+                chunks.emplace_back(begin, end - begin);
+                chunkOptions.emplace_back(makeOptions(items.subspan(begin, end - begin)));
+            }
+
+            auto raws = FetchChunks(chunkOptions, std::move(progressReport), stopToken);
+
+            T merged;
+            for (std::size_t i = 0; i < chunkCount; i++) {
+                auto chunk = ParseRawResponse<T>(*raws[i]);
+                if (!chunk.IsSuccessful() || !chunk.responseData.has_value()) {
+                    merged.failedChunks.emplace_back(BatchChunkFailure{chunks[i].first, chunks[i].second, raws[i]->httpCode, raws[i]->curlStatus});
+                    continue;
+                }
+                RecordBatchResponseMisses(chunkOptions[i], chunk);
+
+                if (!merged.responseData.has_value()) {
+                    merged.HttpCode = chunk.HttpCode;
+                    merged.CurlStatus = chunk.CurlStatus;
+                    merged.responseData.emplace();
+                }
+                AppendBatchData(merged.responseData.value(), std::move(chunk.responseData.value()));
+            }
+
+            if (!merged.responseData.has_value()) {
+                merged.HttpCode = raws.front()->httpCode;
+                merged.CurlStatus = raws.front()->curlStatus;
+            }
+            return merged;
+        }
+    }
+
+    /// @brief batch lookup sync. up to MaxBatchSize items is a single request, more get split into even chunks that are fetched concurrently.
+    /// the merged response has the http code of the first chunk that succeeded, or of the first chunk if none did, and lists the chunks that failed in failedChunks.
+    /// ids the negative cache knows are missing aren't requested, the response doesn't have them just like any other missing id
+    /// @param items the ids to look up
+    /// @param makeOptions creates the url options for a chunk of at most MaxBatchSize items
+    template<typename T, typename Item>
+    T FetchBatch(std::span<Item const> items, WebUtils::URLOptions(*makeOptions)(std::span<Item const>), progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (GetNegativeCacheTTL().count() <= 0) return Detail::FetchBatchChunks<T, Item>(items, makeOptions, std::move(progressReport), stopToken);
+
+        std::vector<Item> wanted;
+        // index in items of every wanted id
+        std::vector<std::size_t> positions;
+        for (std::size_t i = 0; i < items.size(); i++) {
+            if (Detail::IsKnownMissing(makeOptions(items.subspan(i, 1)))) continue;
+            wanted.emplace_back(items[i]);
+            positions.emplace_back(i);
+        }
+        if (wanted.size() == items.size()) return Detail::FetchBatchChunks<T, Item>(items, makeOptions, std::move(progressReport), stopToken);
+
+        // a lone id is answered with a bare map keyed by its newest hash instead of by the id asked for, so one left out id goes along with it
+        if (wanted.size() == 1) {
+            std::size_t extra = positions.front() == 0 ? 1 : 0;
+            std::size_t at = extra < positions.front() ? 0 : 1;
+            wanted.insert(wanted.begin() + at, items[extra]);
+            positions.insert(positions.begin() + at, extra);
+        }
+
+        if (wanted.empty()) {
+            T response;
+            response.HttpCode = 200;
+            response.responseData.emplace();
+            if (progressReport) progressReport(1.0f);
+            return response;
+        }
+
+        auto response = Detail::FetchBatchChunks<T, Item>(wanted, makeOptions, std::move(progressReport), stopToken);
+        // chunk offsets are into the wanted ids, a failed chunk then covers the ids between its first and last one, left out ones included
+        for (auto& failure : response.failedChunks) {
+            auto first = positions[failure.offset];
+            auto last = positions[failure.offset + failure.count - 1];
+            failure.offset = first;
+            failure.count = last - first + 1;
+        }
+        return response;
+    }
+
+    /// @brief batch lookup async, see FetchBatch
+    /// @param onFinished method called when request is done void(std::optional<T>)
+    template<typename T, typename Item>
+    void FetchBatchAsync(std::span<Item const> items, WebUtils::URLOptions(*makeOptions)(std::span<Item const>), finished_opt_function<T> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        // the span may be gone by the time the task runs
+        Executor::GetInstance().Post([items = std::vector<Item>(items.begin(), items.end()), makeOptions, onFinished = std::move(onFinished), progressReport = std::move(progressReport), stopToken]() {
+            auto response = FetchBatch<T, Item>(items, makeOptions, progressReport, stopToken);
+            if (onFinished) onFinished(std::move(response));
+        });
+    }
+
+    /// @brief batch lookup async, see FetchBatch
+    /// @return Future<T>
+    template<typename T, typename Item>
+    Future<T> FetchBatchAsync(std::span<Item const> items, WebUtils::URLOptions(*makeOptions)(std::span<Item const>), progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Executor::GetInstance().Submit([items = std::vector<Item>(items.begin(), items.end()), makeOptions, progressReport = std::move(progressReport), stopToken]() {
+            return FetchBatch<T, Item>(items, makeOptions, progressReport, stopToken);
+        });
+    }
+
+    /// @brief opt in to collecting single GetBeatmapByKey, GetBeatmapByHash and GetUserById lookups that arrive within the batch window,
+    /// and getting them with one batch request instead. sync lookups made from executor threads aren't batched, they would hold a thread the batch may need
+    BEATSAVER_PLUSPLUS_EXPORT void SetLookupBatching(bool enabled);
+
+    /// @brief whether single lookups are batched, defaults to false
+    BEATSAVER_PLUSPLUS_EXPORT bool GetLookupBatching();
+
+    /// @brief set how long the first lookup of a batch waits for others to join it, a batch of MaxBatchSize goes out right away
+    BEATSAVER_PLUSPLUS_EXPORT void SetLookupBatchWindow(std::chrono::milliseconds window);
+
+    /// @brief get how long the first lookup of a batch waits for others to join it, defaults to 10ms
+    BEATSAVER_PLUSPLUS_EXPORT std::chrono::milliseconds GetLookupBatchWindow();
+
+    /// @brief looks up a beatmap by key through the lookup batcher, a key the batch didn't return gets a 404
+    /// @param onFinished called with the result, on the thread that finished the batch
+    BEATSAVER_PLUSPLUS_EXPORT void LoadBeatmapByKey(std::string key, std::function<void(BeatmapResponse)> onFinished);
+
+    /// @brief looks up a beatmap by hash through the lookup batcher, a hash the batch didn't return gets a 404
+    /// @param onFinished called with the result, on the thread that finished the batch
+    BEATSAVER_PLUSPLUS_EXPORT void LoadBeatmapByHash(std::string hash, std::function<void(BeatmapResponse)> onFinished);
+
+    /// @brief looks up a user by id through the lookup batcher, an id the batch didn't return gets a 404
+    /// @param onFinished called with the result, on the thread that finished the batch
+    BEATSAVER_PLUSPLUS_EXPORT void LoadUserById(int id, std::function<void(UserDetailResponse)> onFinished);
+
+    /// @brief single lookup through the lookup batcher as a future
+    template<typename T, typename Id>
+    Future<T> BatchedLookupAsync(void(*load)(Id, std::function<void(T)>), Id id, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        Promise<T> promise;
+        auto future = promise.GetFuture();
+        if (stopToken.stop_requested()) {
+            T cancelled;
+            cancelled.CurlStatus = CancelledCurlStatus;
+            promise.SetValue(std::move(cancelled));
+            return future;
+        }
+
+        load(std::move(id), [promise, progressReport = std::move(progressReport)](T response) mutable {
+            if (progressReport) progressReport(1.0f);
+            promise.SetValue(std::move(response));
+        });
+        return future;
+    }
+
+    /// @brief single lookup through the lookup batcher async
+    /// @param onFinished method called when the lookup is done void(std::optional<T>)
+    template<typename T, typename Id>
+    void BatchedLookupAsync(void(*load)(Id, std::function<void(T)>), Id id, finished_opt_function<T> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (stopToken.stop_requested()) {
+            T cancelled;
+            cancelled.CurlStatus = CancelledCurlStatus;
+            if (onFinished) onFinished(std::move(cancelled));
+            return;
+        }
+
+        load(std::move(id), [onFinished = std::move(onFinished), progressReport = std::move(progressReport)](T response) {
+            if (progressReport) progressReport(1.0f);
+            if (onFinished) onFinished(std::move(response));
+        });
+    }
+
+    /// @brief single lookup through the lookup batcher sync
+    /// @param stopToken when stop is requested the caller stops waiting, the lookup stays in its batch
+    template<typename T, typename Id>
+    T BatchedLookup(void(*load)(Id, std::function<void(T)>), Id id, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        auto future = BatchedLookupAsync<T, Id>(load, std::move(id), std::move(progressReport), stopToken);
+        if (!future.wait(stopToken)) {
+            T cancelled;
+            cancelled.CurlStatus = CancelledCurlStatus;
+            return cancelled;
+        }
+        return future.get();
+    }
+
+    /// @brief whether a sync single lookup on this thread should go through the lookup batcher
+    inline bool ShouldBatchLookup() {
+        return GetLookupBatching() && !Executor::IsExecutorThread();
+    }
+#pragma endregion // requests
+
+
 #pragma region maps
     enum class LatestSortOrder {
         FirstPublished,
@@ -246,11 +1023,14 @@ namespace BeatSaver::API {
     /// @brief get beatmap by key sync
     /// @param key beatmap key
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return BeatmapResponse
-    inline auto GetBeatmapByKey(std::string key, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(
+    inline auto GetBeatmapByKey(std::string key, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (ShouldBatchLookup()) return BatchedLookup<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(&LoadBeatmapByKey, std::move(key), progressReport, stopToken);
+        return Fetch<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(
             GetBeatmapByKeyURLOptions(key),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -258,22 +1038,28 @@ namespace BeatSaver::API {
     /// @param key beatmap key
     /// @param onFinished method called when request is done void(std::optional<BeatmapResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetBeatmapByKeyAsync(std::string key, finished_opt_function<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>> onFinished, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetBeatmapByKeyAsync(std::string key, finished_opt_function<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (GetLookupBatching()) return BatchedLookupAsync<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(&LoadBeatmapByKey, std::move(key), onFinished, progressReport, stopToken);
+        return FetchAsync<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(
             GetBeatmapByKeyURLOptions(key),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get beatmap by key async
     /// @param key beatmap key
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<BeatmapResponse>
-    inline auto GetBeatmapByKeyAsync(std::string key, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<BeatmapResponse>
+    inline auto GetBeatmapByKeyAsync(std::string key, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (GetLookupBatching()) return BatchedLookupAsync<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(&LoadBeatmapByKey, std::move(key), progressReport, stopToken);
+        return FetchAsync<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(
             GetBeatmapByKeyURLOptions(key),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -281,8 +1067,8 @@ namespace BeatSaver::API {
     /// @param keys span of keys to get the beatmap infos for
     /// @return urloptions to use with webutils, expects a return of map<std::string (key), BeatSaver::API::BeatmapResponse>
     inline WebUtils::URLOptions GetBeatmapsByKeysURLOptions(std::span<std::string const> keys) {
-        // this api call limits you to providing 1-50 ids, so we take a view of the span that limits this
-        auto subSpan = keys.subspan(0, std::min<std::size_t>(50, keys.size()));
+        // this api call limits you to providing 1-50 ids, so we take a view of the span that limits this. GetBeatmapsByKeys splits bigger batches up
+        auto subSpan = keys.subspan(0, std::min<std::size_t>(MaxBatchSize, keys.size()));
         return WebUtils::URLOptions{
             fmt::format(BEATSAVER_API_URL "/maps/ids/{}", fmt::join(subSpan, ","))
         };
@@ -290,37 +1076,46 @@ namespace BeatSaver::API {
 
     DECLARE_BEATSAVER_RESPONSE_T(GetBeatmapsByKeysURLOptions, BeatmapMapResponse);
 
-    /// @brief get multiple beatmaps by keys sync
+    /// @brief get multiple beatmaps by keys sync. more than MaxBatchSize are split into requests of at most that many, which run concurrently and get merged into one response
     /// @param keys the beatmap keys to get info for
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return BeatmapMapResponse
-    inline auto GetBeatmapsByKeys(std::span<std::string const> keys, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetBeatmapsByKeysURLOptions>>(
-            GetBeatmapsByKeysURLOptions(keys),
-            progressReport
+    inline auto GetBeatmapsByKeys(std::span<std::string const> keys, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatch<BeatSaverResponse_t<&GetBeatmapsByKeysURLOptions>>(
+            keys,
+            &GetBeatmapsByKeysURLOptions,
+            progressReport,
+            stopToken
         );
     }
 
-    /// @brief get multiple beatmaps by keys async
+    /// @brief get multiple beatmaps by keys async. more than MaxBatchSize are split into requests of at most that many, which run concurrently and get merged into one response
     /// @param keys the beatmap keys to get info for
     /// @param progressReport method called to report download progress, void(float) 0-1
     /// @param onFinished method called when request is done void(std::optional<BeatmapMapResponse>)
-    inline auto GetBeatmapsByKeysAsync(std::span<std::string const> keys, finished_opt_function<BeatSaverResponse_t<&GetBeatmapsByKeysURLOptions>> onFinished, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetBeatmapsByKeysURLOptions>>(
-            GetBeatmapsByKeysURLOptions(keys),
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetBeatmapsByKeysAsync(std::span<std::string const> keys, finished_opt_function<BeatSaverResponse_t<&GetBeatmapsByKeysURLOptions>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatchAsync<BeatSaverResponse_t<&GetBeatmapsByKeysURLOptions>>(
+            keys,
+            &GetBeatmapsByKeysURLOptions,
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
-    /// @brief get multiple beatmaps by keys async
+    /// @brief get multiple beatmaps by keys async. more than MaxBatchSize are split into requests of at most that many, which run concurrently and get merged into one response
     /// @param keys the beatmap keys to get info for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<BeatmapMapResponse>
-    inline auto GetBeatmapsByKeysAsync(std::span<std::string const> keys, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetBeatmapsByKeysURLOptions>>(
-            GetBeatmapsByKeysURLOptions(keys),
-            progressReport
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<BeatmapMapResponse>
+    inline auto GetBeatmapsByKeysAsync(std::span<std::string const> keys, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatchAsync<BeatSaverResponse_t<&GetBeatmapsByKeysURLOptions>>(
+            keys,
+            &GetBeatmapsByKeysURLOptions,
+            progressReport,
+            stopToken
         );
     }
 
@@ -338,11 +1133,14 @@ namespace BeatSaver::API {
     /// @brief get beatmap by hash sync
     /// @param hash beatmap hash
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return BeatmapResponse
-    inline auto GetBeatmapByHash(std::string hash, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(
+    inline auto GetBeatmapByHash(std::string hash, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (ShouldBatchLookup()) return BatchedLookup<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(&LoadBeatmapByHash, std::move(hash), progressReport, stopToken);
+        return Fetch<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(
             GetBeatmapByHashURLOptions(hash),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -350,22 +1148,28 @@ namespace BeatSaver::API {
     /// @param hash beatmap hash
     /// @param onFinished method called when request is done void(std::optional<BeatmapResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetBeatmapByHashAsync(std::string hash, finished_opt_function<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>> onFinished, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetBeatmapByHashAsync(std::string hash, finished_opt_function<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (GetLookupBatching()) return BatchedLookupAsync<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(&LoadBeatmapByHash, std::move(hash), onFinished, progressReport, stopToken);
+        return FetchAsync<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(
             GetBeatmapByHashURLOptions(hash),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get beatmap by hash async
     /// @param hash beatmap hash
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<BeatmapResponse>
-    inline auto GetBeatmapByHashAsync(std::string hash, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<BeatmapResponse>
+    inline auto GetBeatmapByHashAsync(std::string hash, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (GetLookupBatching()) return BatchedLookupAsync<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(&LoadBeatmapByHash, std::move(hash), progressReport, stopToken);
+        return FetchAsync<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(
             GetBeatmapByHashURLOptions(hash),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -373,8 +1177,8 @@ namespace BeatSaver::API {
     /// @param hashes span of hashes to get the beatmap infos for
     /// @return urloptions to use with webutils, expects a return of map<std::string (hash), BeatSaver::API::BeatmapResponse>
     inline WebUtils::URLOptions GetBeatmapsByHashesURLOptions(std::span<std::string const> hashes) {
-        // this api call limits you to providing 1-50 hashes, so we take a view of the span that limits this
-        auto subSpan = hashes.subspan(0, std::min<std::size_t>(50, hashes.size()));
+        // this api call limits you to providing 1-50 hashes, so we take a view of the span that limits this. GetBeatmapsByHashes splits bigger batches up
+        auto subSpan = hashes.subspan(0, std::min<std::size_t>(MaxBatchSize, hashes.size()));
         return WebUtils::URLOptions{
             fmt::format(BEATSAVER_API_URL "/maps/hash/{}", fmt::join(subSpan, ","))
         };
@@ -382,37 +1186,46 @@ namespace BeatSaver::API {
 
     DECLARE_BEATSAVER_RESPONSE_T(GetBeatmapsByHashesURLOptions, BeatmapMapResponse);
 
-    /// @brief get multiple beatmaps by hashes sync
+    /// @brief get multiple beatmaps by hashes sync. more than MaxBatchSize are split into requests of at most that many, which run concurrently and get merged into one response
     /// @param hashes the beatmap hashes to get info for
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return BeatmapMapResponse
-    inline auto GetBeatmapsByHashes(std::span<std::string const> hashes, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetBeatmapsByHashesURLOptions>>(
-            GetBeatmapsByHashesURLOptions(hashes),
-            progressReport
+    inline auto GetBeatmapsByHashes(std::span<std::string const> hashes, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatch<BeatSaverResponse_t<&GetBeatmapsByHashesURLOptions>>(
+            hashes,
+            &GetBeatmapsByHashesURLOptions,
+            progressReport,
+            stopToken
         );
     }
 
-    /// @brief get multiple beatmaps by hashes async
+    /// @brief get multiple beatmaps by hashes async. more than MaxBatchSize are split into requests of at most that many, which run concurrently and get merged into one response
     /// @param hashes the beatmap hashes to get info for
     /// @param onFinished method called when request is done void(std::optional<BeatmapMapResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetBeatmapsByHashesAsync(std::span<std::string const> hashes, finished_opt_function<BeatSaverResponse_t<&GetBeatmapsByHashesURLOptions>> onFinished, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetBeatmapsByHashesURLOptions>>(
-            GetBeatmapsByHashesURLOptions(hashes),
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetBeatmapsByHashesAsync(std::span<std::string const> hashes, finished_opt_function<BeatSaverResponse_t<&GetBeatmapsByHashesURLOptions>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatchAsync<BeatSaverResponse_t<&GetBeatmapsByHashesURLOptions>>(
+            hashes,
+            &GetBeatmapsByHashesURLOptions,
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
-    /// @brief get multiple beatmaps by hashes async
+    /// @brief get multiple beatmaps by hashes async. more than MaxBatchSize are split into requests of at most that many, which run concurrently and get merged into one response
     /// @param hashes the beatmap hashes to get info for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<BeatmapMapResponse>
-    inline auto GetBeatmapsByHashesAsync(std::span<std::string const> hashes, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetBeatmapsByHashesURLOptions>>(
-            GetBeatmapsByHashesURLOptions(hashes),
-            progressReport
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<BeatmapMapResponse>
+    inline auto GetBeatmapsByHashesAsync(std::span<std::string const> hashes, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatchAsync<BeatSaverResponse_t<&GetBeatmapsByHashesURLOptions>>(
+            hashes,
+            &GetBeatmapsByHashesURLOptions,
+            progressReport,
+            stopToken
         );
     }
 
@@ -432,11 +1245,13 @@ namespace BeatSaver::API {
     /// @param id user id
     /// @param page page of info to get
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return SearchPageResponse
-    inline auto GetBeatmapsByUser(int id, int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>>(
+    inline auto GetBeatmapsByUser(int id, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>>(
             GetBeatmapsByUserURLOptions(id, page),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -445,11 +1260,13 @@ namespace BeatSaver::API {
     /// @param onFinished method called when request is done void(std::optional<SearchPageResponse>)
     /// @param page page of info to get
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetBeatmapsByUserAsync(int id, finished_opt_function<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>> onFinished, int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetBeatmapsByUserAsync(int id, finished_opt_function<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>> onFinished, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>>(
             GetBeatmapsByUserURLOptions(id, page),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -457,11 +1274,13 @@ namespace BeatSaver::API {
     /// @param id user id
     /// @param page page of info to get
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<SearchPageResponse>
-    inline auto GetBeatmapsByUserAsync(int id, int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<SearchPageResponse>
+    inline auto GetBeatmapsByUserAsync(int id, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>>(
             GetBeatmapsByUserURLOptions(id, page),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -482,11 +1301,13 @@ namespace BeatSaver::API {
     /// @param id user id
     /// @param queryOptions options to pass along
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return SearchPageResponse
-    inline auto GetCollaborationsByUser(int id, CollaborationQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>>(
+    inline auto GetCollaborationsByUser(int id, CollaborationQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>>(
             GetCollaborationsByUserURLOptions(id, queryOptions),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -495,11 +1316,13 @@ namespace BeatSaver::API {
     /// @param onFinished method called when request is done void(std::optional<SearchPageResponse>)
     /// @param queryOptions options to pass along
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetCollaborationsByUserAsync(int id, finished_opt_function<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>> onFinished, CollaborationQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetCollaborationsByUserAsync(int id, finished_opt_function<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>> onFinished, CollaborationQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>>(
             GetCollaborationsByUserURLOptions(id, queryOptions),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -507,11 +1330,13 @@ namespace BeatSaver::API {
     /// @param id user id
     /// @param queryOptions options to pass along
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<SearchPageResponse>
-    inline auto GetCollaborationsByUserAsync(int id, CollaborationQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<SearchPageResponse>
+    inline auto GetCollaborationsByUserAsync(int id, CollaborationQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>>(
             GetCollaborationsByUserURLOptions(id, queryOptions),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -531,11 +1356,13 @@ namespace BeatSaver::API {
     /// @brief get latest beatmaps sync
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return SearchPageResponse
-    inline auto GetLatest(LatestQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetLatestURLOptions>>(
+    inline auto GetLatest(LatestQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetLatestURLOptions>>(
             GetLatestURLOptions(queryOptions),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -543,22 +1370,60 @@ namespace BeatSaver::API {
     /// @param onFinished method called when request is done void(std::optional<SearchPageResponse>)
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetLatestAsync(finished_opt_function<BeatSaverResponse_t<&GetLatestURLOptions>> onFinished, LatestQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetLatestURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetLatestAsync(finished_opt_function<BeatSaverResponse_t<&GetLatestURLOptions>> onFinished, LatestQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetLatestURLOptions>>(
             GetLatestURLOptions(queryOptions),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get latest beatmaps async
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<SearchPageResponse>
-    inline auto GetLatestAsync(LatestQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetLatestURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<SearchPageResponse>
+    inline auto GetLatestAsync(LatestQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetLatestURLOptions>>(
+            GetLatestURLOptions(queryOptions),
+            progressReport,
+            stopToken
+        );
+    }
+
+    /// @brief get latest beatmaps sync, stale while revalidate. a kept page is returned right away and refreshed in the background if it's older than the policy allows
+    /// @param queryOptions misc query options
+    /// @param policy how old a kept page may be
+    /// @param onRefreshed method called on the executor with the refreshed page, only if it differs from the returned one
+    /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the caller stops waiting, and a background refresh is dropped if it hasn't started yet
+    /// @return SearchPageResponse
+    inline auto GetLatestStaleWhileRevalidate(LatestQueryOptions queryOptions, StaleWhileRevalidate policy, std::function<void(BeatSaverResponse_t<&GetLatestURLOptions>)> onRefreshed, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchStaleWhileRevalidate<BeatSaverResponse_t<&GetLatestURLOptions>>(
             GetLatestURLOptions(queryOptions),
-            progressReport
+            policy,
+            onRefreshed,
+            progressReport,
+            stopToken
+        );
+    }
+
+    /// @brief get latest beatmaps async, stale while revalidate. a kept page resolves the future right away and is refreshed in the background if it's older than the policy allows
+    /// @param queryOptions misc query options
+    /// @param policy how old a kept page may be
+    /// @param onRefreshed method called on the executor with the refreshed page, only if it differs from the returned one
+    /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the caller stops waiting, and a background refresh is dropped if it hasn't started yet
+    /// @return Future<SearchPageResponse>
+    inline auto GetLatestStaleWhileRevalidateAsync(LatestQueryOptions queryOptions, StaleWhileRevalidate policy, std::function<void(BeatSaverResponse_t<&GetLatestURLOptions>)> onRefreshed, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchStaleWhileRevalidateAsync<BeatSaverResponse_t<&GetLatestURLOptions>>(
+            GetLatestURLOptions(queryOptions),
+            policy,
+            onRefreshed,
+            progressReport,
+            stopToken
         );
     }
 
@@ -576,11 +1441,13 @@ namespace BeatSaver::API {
     /// @brief get beatmaps by plays sync
     /// @param page the page to get the info for
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return SearchPageResponse
-    inline auto GetPlays(int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetPlaysURLOptions>>(
+    inline auto GetPlays(int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetPlaysURLOptions>>(
             GetPlaysURLOptions(page),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -588,22 +1455,26 @@ namespace BeatSaver::API {
     /// @param onFinished method called when request is done void(std::optional<SearchPageResponse>)
     /// @param page the page to get the info for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetPlaysAsync(finished_opt_function<BeatSaverResponse_t<&GetPlaysURLOptions>> onFinished, int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetPlaysURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetPlaysAsync(finished_opt_function<BeatSaverResponse_t<&GetPlaysURLOptions>> onFinished, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetPlaysURLOptions>>(
             GetPlaysURLOptions(page),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get beatmaps by plays async
     /// @param page the page to get the info for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<SearchPageResponse>
-    inline auto GetPlaysAsync(int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetPlaysURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<SearchPageResponse>
+    inline auto GetPlaysAsync(int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetPlaysURLOptions>>(
             GetPlaysURLOptions(page),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -624,11 +1495,14 @@ namespace BeatSaver::API {
     /// @brief get user by id sync
     /// @param id the user id to get info for
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return UserDetailResponse
-    inline auto GetUserById(int id, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetUserByIdURLOptions>>(
+    inline auto GetUserById(int id, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (ShouldBatchLookup()) return BatchedLookup<BeatSaverResponse_t<&GetUserByIdURLOptions>>(&LoadUserById, id, progressReport, stopToken);
+        return Fetch<BeatSaverResponse_t<&GetUserByIdURLOptions>>(
             GetUserByIdURLOptions(id),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -636,22 +1510,28 @@ namespace BeatSaver::API {
     /// @param id the user id to get info for
     /// @param onFinished method called when request is done void(std::optional<UserDetailResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetUserByIdAsync(int id, finished_opt_function<BeatSaverResponse_t<&GetUserByIdURLOptions>> onFinished, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetUserByIdURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetUserByIdAsync(int id, finished_opt_function<BeatSaverResponse_t<&GetUserByIdURLOptions>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (GetLookupBatching()) return BatchedLookupAsync<BeatSaverResponse_t<&GetUserByIdURLOptions>>(&LoadUserById, id, onFinished, progressReport, stopToken);
+        return FetchAsync<BeatSaverResponse_t<&GetUserByIdURLOptions>>(
             GetUserByIdURLOptions(id),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get user by id async
     /// @param id the user id to get info for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<UserDetailResponse>
-    inline auto GetUserByIdAsync(int id, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetUserByIdURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<UserDetailResponse>
+    inline auto GetUserByIdAsync(int id, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (GetLookupBatching()) return BatchedLookupAsync<BeatSaverResponse_t<&GetUserByIdURLOptions>>(&LoadUserById, id, progressReport, stopToken);
+        return FetchAsync<BeatSaverResponse_t<&GetUserByIdURLOptions>>(
             GetUserByIdURLOptions(id),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -659,7 +1539,8 @@ namespace BeatSaver::API {
     /// @param ids the user ids to get the details for
     /// @return urloptions to use with webutils, expects a return of array<BeatSaver::API::UserDetailResponse>
     inline WebUtils::URLOptions GetUsersByIdsURLOptions(std::span<int const> ids) {
-        auto subSpan = ids.subspan(0, std::min<std::size_t>(50, ids.size()));
+        // same 1-50 limit as the map lookups, GetUsersByIds splits bigger batches up
+        auto subSpan = ids.subspan(0, std::min<std::size_t>(MaxBatchSize, ids.size()));
         return WebUtils::URLOptions{
             fmt::format(BEATSAVER_API_URL "/users/ids/{}", fmt::join(subSpan, ","))
         };
@@ -667,37 +1548,46 @@ namespace BeatSaver::API {
 
     DECLARE_BEATSAVER_RESPONSE_T(GetUsersByIdsURLOptions, UserDetailArrayResponse);
 
-    /// @brief get users by ids sync
+    /// @brief get users by ids sync. more than MaxBatchSize are split into requests of at most that many, which run concurrently and get merged into one response
     /// @param ids the user ids to get info for
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return UserDetailArrayResponse
-    inline auto GetUsersByIds(std::span<int const> ids, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetUsersByIdsURLOptions>>(
-            GetUsersByIdsURLOptions(ids),
-            progressReport
+    inline auto GetUsersByIds(std::span<int const> ids, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatch<BeatSaverResponse_t<&GetUsersByIdsURLOptions>>(
+            ids,
+            &GetUsersByIdsURLOptions,
+            progressReport,
+            stopToken
         );
     }
 
-    /// @brief get users by ids async
+    /// @brief get users by ids async. more than MaxBatchSize are split into requests of at most that many, which run concurrently and get merged into one response
     /// @param ids the user ids to get info for
     /// @param onFinished method called when request is done void(std::optional<UserDetailArrayResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetUsersByIdsAsync(std::span<int const> ids, finished_opt_function<BeatSaverResponse_t<&GetUsersByIdsURLOptions>> onFinished, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetUsersByIdsURLOptions>>(
-            GetUsersByIdsURLOptions(ids),
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetUsersByIdsAsync(std::span<int const> ids, finished_opt_function<BeatSaverResponse_t<&GetUsersByIdsURLOptions>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatchAsync<BeatSaverResponse_t<&GetUsersByIdsURLOptions>>(
+            ids,
+            &GetUsersByIdsURLOptions,
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
-    /// @brief get users by ids async
+    /// @brief get users by ids async. more than MaxBatchSize are split into requests of at most that many, which run concurrently and get merged into one response
     /// @param ids the user ids to get info for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<UserDetailArrayResponse>
-    inline auto GetUsersByIdsAsync(std::span<int const> ids, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetUsersByIdsURLOptions>>(
-            GetUsersByIdsURLOptions(ids),
-            progressReport
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<UserDetailArrayResponse>
+    inline auto GetUsersByIdsAsync(std::span<int const> ids, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatchAsync<BeatSaverResponse_t<&GetUsersByIdsURLOptions>>(
+            ids,
+            &GetUsersByIdsURLOptions,
+            progressReport,
+            stopToken
         );
     }
 
@@ -715,11 +1605,13 @@ namespace BeatSaver::API {
     /// @brief get user by username sync
     /// @param userName the username to get the user for
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return UserDetailResponse
-    inline auto GetUserByName(std::string userName, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetUserByNameURLOptions>>(
+    inline auto GetUserByName(std::string userName, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetUserByNameURLOptions>>(
             GetUserByNameURLOptions(userName),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -727,22 +1619,26 @@ namespace BeatSaver::API {
     /// @param userName the username to get the user for
     /// @param onFinished method called when request is done void(std::optional<UserDetailResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetUserByNameAsync(std::string userName, finished_opt_function<BeatSaverResponse_t<&GetUserByNameURLOptions>> onFinished, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetUserByNameURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetUserByNameAsync(std::string userName, finished_opt_function<BeatSaverResponse_t<&GetUserByNameURLOptions>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetUserByNameURLOptions>>(
             GetUserByNameURLOptions(userName),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get user by username async
     /// @param userName the username to get the user for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<UserDetailResponse>
-    inline auto GetUserByNameAsync(std::string userName, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetUserByNameURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<UserDetailResponse>
+    inline auto GetUserByNameAsync(std::string userName, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetUserByNameURLOptions>>(
             GetUserByNameURLOptions(userName),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -760,11 +1656,14 @@ namespace BeatSaver::API {
     /// @brief get avatar image sync
     /// @param userDetail the user to get the avatar image for
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return DataResponse
-    inline auto GetAvatarImage(Models::UserDetail const& userDetail, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetAvatarImageURLOptions>>(
+    inline auto GetAvatarImage(Models::UserDetail const& userDetail, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchCachedAsset<BeatSaverResponse_t<&GetAvatarImageURLOptions>>(
             GetAvatarImageURLOptions(userDetail),
-            progressReport
+            "",
+            progressReport,
+            stopToken
         );
     }
 
@@ -772,22 +1671,28 @@ namespace BeatSaver::API {
     /// @param userDetail the user to get the avatar image for
     /// @param onFinished method called when request is done void(std::optional<DataResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetAvatarImageAsync(Models::UserDetail const& userDetail, finished_opt_function<BeatSaverResponse_t<&GetAvatarImageURLOptions>> onFinished, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetAvatarImageURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetAvatarImageAsync(Models::UserDetail const& userDetail, finished_opt_function<BeatSaverResponse_t<&GetAvatarImageURLOptions>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchCachedAssetAsync<BeatSaverResponse_t<&GetAvatarImageURLOptions>>(
             GetAvatarImageURLOptions(userDetail),
+            "",
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get avatar image async
     /// @param userDetail the user to get the avatar image for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<DataResponse>
-    inline auto GetAvatarImageAsync(Models::UserDetail const& userDetail, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetAvatarImageURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<DataResponse>
+    inline auto GetAvatarImageAsync(Models::UserDetail const& userDetail, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchCachedAssetAsync<BeatSaverResponse_t<&GetAvatarImageURLOptions>>(
             GetAvatarImageURLOptions(userDetail),
-            progressReport
+            "",
+            progressReport,
+            stopToken
         );
     }
 
@@ -832,12 +1737,14 @@ namespace BeatSaver::API {
     /// @param auth user authorization
     /// @param progressReport method called to report download progress, void(float) 0-1
     /// @return VerifyResponse
-    inline auto PostVerify(PlatformAuth auth, progress_function progressReport = nullptr) {
+    /// @param stopToken when stop is requested no new attempt is started
+    inline auto PostVerify(PlatformAuth auth, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
         auto [url, data] = PostVerifyURLOptionsAndData(auth);
-        return GetBeatsaverDownloader().Post<BeatSaverResponse_t<&PostVerifyURLOptionsAndData>>(
+        return PostData<BeatSaverResponse_t<&PostVerifyURLOptionsAndData>>(
             url,
             {(uint8_t*)data.data(), data.size()},
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -845,34 +1752,38 @@ namespace BeatSaver::API {
     /// @param auth user authorization
     /// @param onFinished method called when request is done void(std::optional<VerifyResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto PostVerifyAsync(PlatformAuth auth, finished_opt_function<BeatSaverResponse_t<&PostVerifyURLOptionsAndData>> onFinished, progress_function progressReport = nullptr) {
+    /// @param stopToken when stop is requested no new attempt is started
+    inline auto PostVerifyAsync(PlatformAuth auth, finished_opt_function<BeatSaverResponse_t<&PostVerifyURLOptionsAndData>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
         auto [url, data] = PostVerifyURLOptionsAndData(auth);
         // post requests are a bit special because we need to be able to keep variables in scope
-        std::thread([](auto url, auto data, auto onFinished, auto progressReport) -> auto {
+        Executor::GetInstance().Post([url = url, data = data, onFinished, progressReport, stopToken]() {
             onFinished(
-                GetBeatsaverDownloader().Post<BeatSaverResponse_t<&PostVerifyURLOptionsAndData>>(
+                PostData<BeatSaverResponse_t<&PostVerifyURLOptionsAndData>>(
                     url,
                     {(uint8_t*)data.data(), data.size()},
-                    progressReport
+                    progressReport,
+                    stopToken
                 )
             );
-        }, url, data, onFinished, progressReport).detach();
+        });
     }
 
     /// @brief post verification request async
     /// @param auth user authorization
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<VerifyResponse>
-    inline auto PostVerifyAsync(PlatformAuth auth, progress_function progressReport = nullptr) {
+    /// @return Future<VerifyResponse>
+    /// @param stopToken when stop is requested no new attempt is started
+    inline auto PostVerifyAsync(PlatformAuth auth, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
         auto [url, data] = PostVerifyURLOptionsAndData(auth);
         // post requests are a bit special because we need to be able to keep variables in scope
-        return std::async([](auto url, auto data, auto progressReport) -> auto {
-            return GetBeatsaverDownloader().Post<BeatSaverResponse_t<&PostVerifyURLOptionsAndData>>(
+        return Executor::GetInstance().Submit([url = url, data = data, progressReport, stopToken]() {
+            return PostData<BeatSaverResponse_t<&PostVerifyURLOptionsAndData>>(
                 url,
                 {(uint8_t*)data.data(), data.size()},
-                progressReport
+                progressReport,
+                stopToken
             );
-        }, url, data, progressReport);
+        });
     }
 #pragma endregion // users
 
@@ -952,11 +1863,13 @@ namespace BeatSaver::API {
     /// @param page page number to get
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return SearchPageResponse
-    inline auto GetPage(int page, SearchQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetPageURLOptions>>(
+    inline auto GetPage(int page, SearchQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetPageURLOptions>>(
             GetPageURLOptions(page, queryOptions),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -965,11 +1878,13 @@ namespace BeatSaver::API {
     /// @param onFinished method called when request is done void(std::optional<SearchPageResponse>)
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetPageAsync(int page, finished_opt_function<BeatSaverResponse_t<&GetPageURLOptions>> onFinished, SearchQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetPageURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetPageAsync(int page, finished_opt_function<BeatSaverResponse_t<&GetPageURLOptions>> onFinished, SearchQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetPageURLOptions>>(
             GetPageURLOptions(page, queryOptions),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -977,11 +1892,49 @@ namespace BeatSaver::API {
     /// @param page page number to get
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<SearchPageResponse>
-    inline auto GetPageAsync(int page, SearchQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetPageURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<SearchPageResponse>
+    inline auto GetPageAsync(int page, SearchQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetPageURLOptions>>(
+            GetPageURLOptions(page, queryOptions),
+            progressReport,
+            stopToken
+        );
+    }
+
+    /// @brief get search page sync, stale while revalidate. a kept page is returned right away and refreshed in the background if it's older than the policy allows
+    /// @param page page number to get
+    /// @param queryOptions misc query options
+    /// @param policy how old a kept page may be
+    /// @param onRefreshed method called on the executor with the refreshed page, only if it differs from the returned one
+    /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the caller stops waiting, and a background refresh is dropped if it hasn't started yet
+    /// @return SearchPageResponse
+    inline auto GetPageStaleWhileRevalidate(int page, SearchQueryOptions queryOptions, StaleWhileRevalidate policy, std::function<void(BeatSaverResponse_t<&GetPageURLOptions>)> onRefreshed, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchStaleWhileRevalidate<BeatSaverResponse_t<&GetPageURLOptions>>(
             GetPageURLOptions(page, queryOptions),
-            progressReport
+            policy,
+            onRefreshed,
+            progressReport,
+            stopToken
+        );
+    }
+
+    /// @brief get search page async, stale while revalidate. a kept page resolves the future right away and is refreshed in the background if it's older than the policy allows
+    /// @param page page number to get
+    /// @param queryOptions misc query options
+    /// @param policy how old a kept page may be
+    /// @param onRefreshed method called on the executor with the refreshed page, only if it differs from the returned one
+    /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the caller stops waiting, and a background refresh is dropped if it hasn't started yet
+    /// @return Future<SearchPageResponse>
+    inline auto GetPageStaleWhileRevalidateAsync(int page, SearchQueryOptions queryOptions, StaleWhileRevalidate policy, std::function<void(BeatSaverResponse_t<&GetPageURLOptions>)> onRefreshed, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchStaleWhileRevalidateAsync<BeatSaverResponse_t<&GetPageURLOptions>>(
+            GetPageURLOptions(page, queryOptions),
+            policy,
+            onRefreshed,
+            progressReport,
+            stopToken
         );
     }
 
@@ -1016,11 +1969,13 @@ namespace BeatSaver::API {
     /// @brief get vote info sync
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return ListOfVoteSummaryResponse
-    inline auto GetVote(VoteQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetVoteURLOptions>>(
+    inline auto GetVote(VoteQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetVoteURLOptions>>(
             GetVoteURLOptions(queryOptions),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1028,22 +1983,26 @@ namespace BeatSaver::API {
     /// @param onFinished method called when request is done void(std::optional<ListOfVoteSummaryResponse>)
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetVoteAsync(finished_opt_function<BeatSaverResponse_t<&GetVoteURLOptions>> onFinished, VoteQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetVoteURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetVoteAsync(finished_opt_function<BeatSaverResponse_t<&GetVoteURLOptions>> onFinished, VoteQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetVoteURLOptions>>(
             GetVoteURLOptions(queryOptions),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get vote info async
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<ListOfVoteSummaryResponse>
-    inline auto GetVoteAsync(VoteQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetVoteURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<ListOfVoteSummaryResponse>
+    inline auto GetVoteAsync(VoteQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetVoteURLOptions>>(
             GetVoteURLOptions(queryOptions),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1074,12 +2033,14 @@ namespace BeatSaver::API {
     /// @param hash the hash of the map to vote for
     /// @param progressReport method called to report download progress, void(float) 0-1
     /// @return VoteResponse
-    inline auto PostVote(PlatformAuth auth, bool direction, std::string hash, progress_function progressReport = nullptr) {
+    /// @param stopToken when stop is requested no new attempt is started
+    inline auto PostVote(PlatformAuth auth, bool direction, std::string hash, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
         auto [url, data] = PostVoteURLOptionsAndData(auth, direction, hash);
-        return GetBeatsaverDownloader().Post<BeatSaverResponse_t<&PostVoteURLOptionsAndData>>(
+        return PostData<BeatSaverResponse_t<&PostVoteURLOptionsAndData>>(
             url,
             {(uint8_t*)data.data(), data.size()},
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1089,18 +2050,20 @@ namespace BeatSaver::API {
     /// @param hash the hash of the map to vote for
     /// @param onFinished method called when request is done void(std::optional<VoteResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto PostVoteAsync(PlatformAuth auth, bool direction, std::string hash, finished_opt_function<BeatSaverResponse_t<&PostVoteURLOptionsAndData>> onFinished, progress_function progressReport = nullptr) {
+    /// @param stopToken when stop is requested no new attempt is started
+    inline auto PostVoteAsync(PlatformAuth auth, bool direction, std::string hash, finished_opt_function<BeatSaverResponse_t<&PostVoteURLOptionsAndData>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
         auto [url, data] = PostVoteURLOptionsAndData(auth, direction, hash);
         // post requests are a bit special because we need to be able to keep variables in scope
-        std::thread([](auto url, auto data, auto onFinished, auto progressReport) -> auto {
+        Executor::GetInstance().Post([url = url, data = data, onFinished, progressReport, stopToken]() {
             onFinished(
-                GetBeatsaverDownloader().Post<BeatSaverResponse_t<&PostVoteURLOptionsAndData>>(
+                PostData<BeatSaverResponse_t<&PostVoteURLOptionsAndData>>(
                     url,
                     {(uint8_t*)data.data(), data.size()},
-                    progressReport
+                    progressReport,
+                    stopToken
                 )
             );
-        }, url, data, onFinished, progressReport).detach();
+        });
     }
 
     /// @brief post a vote async
@@ -1108,17 +2071,19 @@ namespace BeatSaver::API {
     /// @param direction whether this is an up or down vote
     /// @param hash the hash of the map to vote for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<VoteResponse>
-    inline auto PostVoteAsync(PlatformAuth auth, bool direction, std::string hash, progress_function progressReport = nullptr) {
+    /// @return Future<VoteResponse>
+    /// @param stopToken when stop is requested no new attempt is started
+    inline auto PostVoteAsync(PlatformAuth auth, bool direction, std::string hash, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
         auto [url, data] = PostVoteURLOptionsAndData(auth, direction, hash);
         // post requests are a bit special because we need to be able to keep variables in scope
-        return std::async([](auto url, auto data, auto progressReport) -> auto {
-            return GetBeatsaverDownloader().Post<BeatSaverResponse_t<&PostVoteURLOptionsAndData>>(
+        return Executor::GetInstance().Submit([url = url, data = data, progressReport, stopToken]() {
+            return PostData<BeatSaverResponse_t<&PostVoteURLOptionsAndData>>(
                 url,
                 {(uint8_t*)data.data(), data.size()},
-                progressReport
+                progressReport,
+                stopToken
             );
-        }, url, data, progressReport);
+        });
     }
 
 #pragma endregion // vote
@@ -1160,11 +2125,13 @@ namespace BeatSaver::API {
     /// @brief get latest playlists sync
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return PlaylistSearchPageResponse
-    inline auto GetLatestPlaylists(LatestPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>>(
+    inline auto GetLatestPlaylists(LatestPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>>(
             GetLatestPlaylistsURLOptions(queryOptions),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1172,22 +2139,60 @@ namespace BeatSaver::API {
     /// @param onFinished method called when request is done void(std::optional<PlaylistSearchPageResponse>)
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetLatestPlaylistsAsync(finished_opt_function<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>> onFinished, LatestPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetLatestPlaylistsAsync(finished_opt_function<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>> onFinished, LatestPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>>(
             GetLatestPlaylistsURLOptions(queryOptions),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get latest playlists async
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<PlaylistSearchPageResponse>
-    inline auto GetLatestPlaylistsAsync(LatestPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<PlaylistSearchPageResponse>
+    inline auto GetLatestPlaylistsAsync(LatestPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>>(
             GetLatestPlaylistsURLOptions(queryOptions),
-            progressReport
+            progressReport,
+            stopToken
+        );
+    }
+
+    /// @brief get latest playlists sync, stale while revalidate. a kept page is returned right away and refreshed in the background if it's older than the policy allows
+    /// @param queryOptions misc query options
+    /// @param policy how old a kept page may be
+    /// @param onRefreshed method called on the executor with the refreshed page, only if it differs from the returned one
+    /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the caller stops waiting, and a background refresh is dropped if it hasn't started yet
+    /// @return PlaylistSearchPageResponse
+    inline auto GetLatestPlaylistsStaleWhileRevalidate(LatestPlaylistsQueryOptions queryOptions, StaleWhileRevalidate policy, std::function<void(BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>)> onRefreshed, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchStaleWhileRevalidate<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>>(
+            GetLatestPlaylistsURLOptions(queryOptions),
+            policy,
+            onRefreshed,
+            progressReport,
+            stopToken
+        );
+    }
+
+    /// @brief get latest playlists async, stale while revalidate. a kept page resolves the future right away and is refreshed in the background if it's older than the policy allows
+    /// @param queryOptions misc query options
+    /// @param policy how old a kept page may be
+    /// @param onRefreshed method called on the executor with the refreshed page, only if it differs from the returned one
+    /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the caller stops waiting, and a background refresh is dropped if it hasn't started yet
+    /// @return Future<PlaylistSearchPageResponse>
+    inline auto GetLatestPlaylistsStaleWhileRevalidateAsync(LatestPlaylistsQueryOptions queryOptions, StaleWhileRevalidate policy, std::function<void(BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>)> onRefreshed, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchStaleWhileRevalidateAsync<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>>(
+            GetLatestPlaylistsURLOptions(queryOptions),
+            policy,
+            onRefreshed,
+            progressReport,
+            stopToken
         );
     }
 
@@ -1239,11 +2244,13 @@ namespace BeatSaver::API {
     /// @param page page of search results to get
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return PlaylistSearchPageResponse
-    inline auto GetSearchPlaylists(int page = 0, SearchPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>>(
+    inline auto GetSearchPlaylists(int page = 0, SearchPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>>(
             GetSearchPlaylistsURLOptions(page, queryOptions),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1252,11 +2259,13 @@ namespace BeatSaver::API {
     /// @param page page of search results to get
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetSearchPlaylistsAsync(finished_opt_function<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>> onFinished, int page = 0, SearchPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetSearchPlaylistsAsync(finished_opt_function<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>> onFinished, int page = 0, SearchPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>>(
             GetSearchPlaylistsURLOptions(page, queryOptions),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1264,11 +2273,13 @@ namespace BeatSaver::API {
     /// @param page page of search results to get
     /// @param queryOptions misc query options
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<PlaylistSearchPageResponse>
-    inline auto GetSearchPlaylistsAsync(int page = 0, SearchPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<PlaylistSearchPageResponse>
+    inline auto GetSearchPlaylistsAsync(int page = 0, SearchPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>>(
             GetSearchPlaylistsURLOptions(page, queryOptions),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1288,11 +2299,13 @@ namespace BeatSaver::API {
     /// @param userID the user to get playlists for
     /// @param page page of search results to get
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return PlaylistSearchPageResponse
-    inline auto GetUserPlaylists(int userID, int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetUserPlaylistsURLOptions>>(
+    inline auto GetUserPlaylists(int userID, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetUserPlaylistsURLOptions>>(
             GetUserPlaylistsURLOptions(userID, page),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1301,11 +2314,13 @@ namespace BeatSaver::API {
     /// @param onFinished method called when request is done void(std::optional<PlaylistSearchPageResponse>)
     /// @param page page of search results to get
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetUserPlaylistsAsync(int userID, finished_opt_function<BeatSaverResponse_t<&GetUserPlaylistsURLOptions>> onFinished, int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetUserPlaylistsURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetUserPlaylistsAsync(int userID, finished_opt_function<BeatSaverResponse_t<&GetUserPlaylistsURLOptions>> onFinished, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetUserPlaylistsURLOptions>>(
             GetUserPlaylistsURLOptions(userID, page),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1313,11 +2328,13 @@ namespace BeatSaver::API {
     /// @param userID the user to get playlists for
     /// @param page page of search results to get
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<PlaylistSearchPageResponse>
-    inline auto GetUserPlaylistsAsync(int userID, int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetUserPlaylistsURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<PlaylistSearchPageResponse>
+    inline auto GetUserPlaylistsAsync(int userID, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetUserPlaylistsURLOptions>>(
             GetUserPlaylistsURLOptions(userID, page),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1337,11 +2354,13 @@ namespace BeatSaver::API {
     /// @param playlistID the playlist to get info for
     /// @param page page of search results to get
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return PlaylistSearchPageResponse
-    inline auto GetPlaylist(int playlistID, int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetPlaylistURLOptions>>(
+    inline auto GetPlaylist(int playlistID, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return Fetch<BeatSaverResponse_t<&GetPlaylistURLOptions>>(
             GetPlaylistURLOptions(playlistID, page),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1350,11 +2369,13 @@ namespace BeatSaver::API {
     /// @param onFinished method called when request is done void(std::optional<PlaylistSearchPageResponse>)
     /// @param page page of search results to get
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetPlaylistAsync(int playlistID, finished_opt_function<BeatSaverResponse_t<&GetPlaylistURLOptions>> onFinished, int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetPlaylistURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetPlaylistAsync(int playlistID, finished_opt_function<BeatSaverResponse_t<&GetPlaylistURLOptions>> onFinished, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetPlaylistURLOptions>>(
             GetPlaylistURLOptions(playlistID, page),
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1362,11 +2383,13 @@ namespace BeatSaver::API {
     /// @param playlistID the playlist to get info for
     /// @param page page of search results to get
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<PlaylistSearchPageResponse>
-    inline auto GetPlaylistAsync(int playlistID, int page = 0, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetPlaylistURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<PlaylistSearchPageResponse>
+    inline auto GetPlaylistAsync(int playlistID, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAsync<BeatSaverResponse_t<&GetPlaylistURLOptions>>(
             GetPlaylistURLOptions(playlistID, page),
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
@@ -1384,11 +2407,11 @@ namespace BeatSaver::API {
 
         BeatmapDownloadInfo() = default;
         /// @brief info from direct values
-        BeatmapDownloadInfo(std::string Key, std::string DownloadURL, std::string FolderName) : Key(Key), DownloadURL(DownloadURL), FolderName(SanitizeFolderName(FolderName)) {}
+        BeatmapDownloadInfo(std::string Key, std::string DownloadURL, std::string FolderName, std::string Hash = "") : Key(Key), DownloadURL(DownloadURL), FolderName(SanitizeFolderName(FolderName)), Hash(Hash) {}
         /// @brief info from a beatmap, gets the front version to download
         BeatmapDownloadInfo(Models::Beatmap const& beatmap) : BeatmapDownloadInfo(beatmap, beatmap.Versions.front()) {}
         /// @brief info from a beatmap and version
-        BeatmapDownloadInfo(Models::Beatmap const& beatmap, Models::BeatmapVersion const& version) : Key(version.Key.value_or(beatmap.Id)), DownloadURL(version.DownloadURL), FolderName(SanitizeFolderName(Key, beatmap.Metadata.SongName, beatmap.Metadata.LevelAuthorName)) {}
+        BeatmapDownloadInfo(Models::Beatmap const& beatmap, Models::BeatmapVersion const& version) : Key(version.Key.value_or(beatmap.Id)), DownloadURL(version.DownloadURL), FolderName(SanitizeFolderName(Key, beatmap.Metadata.SongName, beatmap.Metadata.LevelAuthorName)), Hash(version.Hash) {}
 
         /// @brief beatmap key, /beatmaps/ids/{key}
         std::string const Key;
@@ -1396,6 +2419,8 @@ namespace BeatSaver::API {
         std::string const DownloadURL;
         /// @brief folder name, the name to use for the folder when saving the map to disk
         std::string const FolderName;
+        /// @brief expected map hash, if not empty the extracted files are checked against it and the map is not installed if they don't match
+        std::string const Hash;
     };
 
     /// @brief response to be used with webutils, can only be used with GetInto due to requiring to know where to unzip the file
@@ -1442,27 +2467,24 @@ namespace BeatSaver::API {
         return std::make_unique<DownloadBeatmapRequest>(info);
     }
 
-    /// @brief method to download a beatmap synchronously
+    /// @brief method to download a beatmap synchronously. the zip is streamed to a file in the data path in chunks of GetDownloadChunkSize and extracted from there.
+    /// the map is extracted into a staging dir first, and only moved into the output path once its hash matched info.Hash
+    /// if the download fails the partial zip is kept, and downloading the same map again resumes it
+    /// if the zip store is enabled and has the map, it is installed from there without downloading
+    /// if skipping installed maps is enabled and this version is installed already, its folder is returned without doing anything
     /// @param info the download info for the map to download
     /// @param progressReport callback for reporting progress
-    /// @return optional path, if set the download was succesful and the map can be found @ that path, nullopt if failed
-    inline std::optional<std::filesystem::path> DownloadBeatmap(BeatmapDownloadInfo info, std::function<void(float)> progressReport = nullptr) {
-        auto [options, response] = DownloadBeatmapURLOptionsAndResponse(info);
-        GetBeatsaverDownloader().GetInto(options, &response, progressReport);
-        return response.responseData;
-    }
+    /// @param stopToken when stop is requested the download stops before the next chunk, keeping the partial zip, and nothing gets installed.
+    /// if other callers share the download it keeps going for them, and only the callers that joined it stop waiting
+    /// @return optional path, if set the download was succesful and the map can be found @ that path, nullopt if failed or stopped
+    BEATSAVER_PLUSPLUS_EXPORT std::optional<std::filesystem::path> DownloadBeatmap(BeatmapDownloadInfo info, std::function<void(float)> progressReport = nullptr, std::stop_token stopToken = {});
 
-    /// @brief downloads a beatmap asynchronously, and calls onFinished after it concludes
+    /// @brief downloads a beatmap asynchronously with a high priority in the DownloadManager, and calls onFinished after it concludes
     /// @param info the download info for the map to download
     /// @param onFinished the method to call once the request is done
     /// @param progressReport callback for reporting progress
-    inline void DownloadBeatmapAsync(BeatmapDownloadInfo info, finished_opt_function<std::filesystem::path> onFinished, std::function<void(float)> progressReport = nullptr) {
-        if (!onFinished) return;
-
-        std::thread([](BeatmapDownloadInfo info, finished_opt_function<std::filesystem::path> onFinished, std::function<void(float)> progressReport){
-            onFinished(DownloadBeatmap(info, progressReport));
-        }, std::forward<BeatmapDownloadInfo>(info), std::forward<finished_opt_function<std::filesystem::path>>(onFinished), std::forward<std::function<void(float)>>(progressReport)).detach();
-    }
+    /// @param stopToken when stop is requested the download is cancelled in the DownloadManager
+    BEATSAVER_PLUSPLUS_EXPORT void DownloadBeatmapAsync(BeatmapDownloadInfo info, finished_opt_function<std::filesystem::path> onFinished, std::function<void(float)> progressReport = nullptr, std::stop_token stopToken = {});
 
     /// @brief creates the necessary url options to download cover image data
     /// @param version the beatmap version to create the url options for
@@ -1478,11 +2500,14 @@ namespace BeatSaver::API {
     /// @brief get cover image sync
     /// @param version the beatmap version to get the cover image for
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return DataResponse
-    inline auto GetCoverImage(Models::BeatmapVersion const& version, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetCoverImageURLOptions>>(
+    inline auto GetCoverImage(Models::BeatmapVersion const& version, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchCachedAsset<BeatSaverResponse_t<&GetCoverImageURLOptions>>(
             GetCoverImageURLOptions(version),
-            progressReport
+            version.Hash,
+            progressReport,
+            stopToken
         );
     }
 
@@ -1490,22 +2515,28 @@ namespace BeatSaver::API {
     /// @param version the beatmap version to get the cover image for
     /// @param onFinished method called when request is done void(std::optional<DataResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetCoverImageAsync(Models::BeatmapVersion const& version, finished_opt_function<BeatSaverResponse_t<&GetCoverImageURLOptions>> onFinished, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetCoverImageURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetCoverImageAsync(Models::BeatmapVersion const& version, finished_opt_function<BeatSaverResponse_t<&GetCoverImageURLOptions>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchCachedAssetAsync<BeatSaverResponse_t<&GetCoverImageURLOptions>>(
             GetCoverImageURLOptions(version),
+            version.Hash,
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get cover image async
     /// @param version the beatmap version to get the cover image for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<DataResponse>
-    inline auto GetCoverImageAsync(Models::BeatmapVersion const& version, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetCoverImageURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<DataResponse>
+    inline auto GetCoverImageAsync(Models::BeatmapVersion const& version, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchCachedAssetAsync<BeatSaverResponse_t<&GetCoverImageURLOptions>>(
             GetCoverImageURLOptions(version),
-            progressReport
+            version.Hash,
+            progressReport,
+            stopToken
         );
     }
 
@@ -1523,11 +2554,14 @@ namespace BeatSaver::API {
     /// @brief get preview data sync
     /// @param version the beatmap version get the preview for
     /// @param progressReport method called to report download progress, void(float) 0-1
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
     /// @return DataResponse
-    inline auto GetPreview(Models::BeatmapVersion const& version, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().Get<BeatSaverResponse_t<&GetPreviewURLOptions>>(
+    inline auto GetPreview(Models::BeatmapVersion const& version, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchCachedAsset<BeatSaverResponse_t<&GetPreviewURLOptions>>(
             GetPreviewURLOptions(version),
-            progressReport
+            version.Hash,
+            progressReport,
+            stopToken
         );
     }
 
@@ -1535,95 +2569,51 @@ namespace BeatSaver::API {
     /// @param version the beatmap version get the preview for
     /// @param onFinished method called when request is done void(std::optional<DataResponse>)
     /// @param progressReport method called to report download progress, void(float) 0-1
-    inline auto GetPreviewAsync(Models::BeatmapVersion const& version, finished_opt_function<BeatSaverResponse_t<&GetPreviewURLOptions>> onFinished, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetPreviewURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    inline auto GetPreviewAsync(Models::BeatmapVersion const& version, finished_opt_function<BeatSaverResponse_t<&GetPreviewURLOptions>> onFinished, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchCachedAssetAsync<BeatSaverResponse_t<&GetPreviewURLOptions>>(
             GetPreviewURLOptions(version),
+            version.Hash,
             onFinished,
-            progressReport
+            progressReport,
+            stopToken
         );
     }
 
     /// @brief get preview data async
     /// @param version the beatmap version get the preview for
     /// @param progressReport method called to report download progress, void(float) 0-1
-    /// @return std::future<DataResponse>
-    inline auto GetPreviewAsync(Models::BeatmapVersion const& version, progress_function progressReport = nullptr) {
-        return GetBeatsaverDownloader().GetAsync<BeatSaverResponse_t<&GetPreviewURLOptions>>(
+    /// @param stopToken when stop is requested the request is dropped if it hasn't started yet, and the caller stops waiting for it
+    /// @return Future<DataResponse>
+    inline auto GetPreviewAsync(Models::BeatmapVersion const& version, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchCachedAssetAsync<BeatSaverResponse_t<&GetPreviewURLOptions>>(
             GetPreviewURLOptions(version),
-            progressReport
+            version.Hash,
+            progressReport,
+            stopToken
         );
     }
 
-    /// @brief download multiple beatmaps in a ratelimited fashion
+    /// @brief download multiple beatmaps with a low priority in the DownloadManager, at most maxConcurrency at a time
     /// @param infos the beatmaps to download
-    /// @param maxConcurrency maximum amount of extra threads to use
+    /// @param maxConcurrency maximum amount of these downloads running at once, the download manager's global limit applies as well.
+    /// 0 or less leaves it to the download manager alone, which is what to use together with its adaptive concurrency
     /// @param progressReport reporter method that lets you know the progress of the downloads
+    /// @param stopToken when stop is requested every download of the batch that hasn't finished is cancelled, they end up as nullopt
     /// @return map of beatmap keys to path results, if a beatmap does not appear in here, it didn't succeed, and if the value is nullopt it didn't download
-    inline std::unordered_map<std::string, std::optional<std::filesystem::path>> DownloadBeatmaps(std::span<BeatmapDownloadInfo const> infos, int maxConcurrency = 4, std::function<void(int, int)> progressReport = nullptr) {
-        std::mutex resultMutex;
-        std::unordered_map<std::string, std::optional<std::filesystem::path>> results;
-        auto setKeyValue = [&resultMutex, &results](std::string key, std::optional<std::filesystem::path> value){
-            std::unique_lock lock(resultMutex);
-            results[key] = value;
-        };
-        WebUtils::RatelimitedDispatcher rl;
-        rl.downloader = GetBeatsaverDownloader();
-        rl.maxConcurrentRequests = std::max(maxConcurrency, 1);
-
-        int total = infos.size();
-        std::atomic_int completed = 0;
-
-        rl.onRequestFinished = [setKeyValue, &progressReport, total, &completed](bool success, auto req) -> std::optional<WebUtils::RatelimitedDispatcher::RetryOptions> {
-            if (!success) {
-                auto targetResponse = req->TargetResponse;
-
-                auto http = targetResponse->HttpCode;
-                auto curl = targetResponse->CurlStatus;
-                // don't retry if curl fails
-                if (curl != 0) return std::nullopt;
+    BEATSAVER_PLUSPLUS_EXPORT std::unordered_map<std::string, std::optional<std::filesystem::path>> DownloadBeatmaps(std::span<BeatmapDownloadInfo const> infos, int maxConcurrency = 4, std::function<void(int, int)> progressReport = nullptr, std::stop_token stopToken = {});
 
-                // http codes other than 2xx we want no retries
-                if (http < 200 || http >= 300) return std::nullopt;
-
-                return WebUtils::RatelimitedDispatcher::RetryOptions{std::chrono::milliseconds(50)};
-            }
-
-            completed++;
-
-            auto beatmapReq = dynamic_cast<DownloadBeatmapRequest*>(req);
-            if (!beatmapReq) return std::nullopt;
-
-            auto key = beatmapReq->response.info.Key;
-            setKeyValue(key, beatmapReq->response.responseData);
-            if (progressReport) progressReport(total, completed);
-
-            return std::nullopt;
-        };
-
-        for (auto& info : infos ) {
-            rl.AddRequest(CreateDownloadBeatmapRequest(info));
-        }
-
-        rl.StartDispatchIfNeeded().wait();
-        if (progressReport) progressReport(total, completed);
-        return results;
-    }
-
-    /// @brief download multiple beatmaps in a ratelimited fashion
+    /// @brief download multiple beatmaps, at most maxConcurrency at a time
     /// @param infos the beatmaps to download
-    /// @param maxConcurrency maximum amount of extra threads to use
+    /// @param maxConcurrency maximum amount of these downloads running at once, 0 or less leaves it to the download manager
     /// @param onFinished method called when finished, gets a map of beatmap keys to path results, if a beatmap does not appear in here, it didn't succeed, and if the value is nullopt it didn't download
     /// @param progressReport reporter method that lets you know the progress of the downloads
-    inline void DownloadBeatmapsAsync(std::span<BeatmapDownloadInfo const> infos, std::function<void(std::unordered_map<std::string, std::optional<std::filesystem::path>>)> onFinished, int maxConcurrency = 4, std::function<void(int, int)> progressReport = nullptr) {
-        if (!onFinished) return;
-
-        std::thread([](std::vector<BeatmapDownloadInfo> infos, std::function<void(std::unordered_map<std::string, std::optional<std::filesystem::path>>)> onFinished, int maxConcurrency, std::function<void(int, int)> progressReport){
-            onFinished(DownloadBeatmaps(infos, maxConcurrency, progressReport));
-        }, std::vector(infos.begin(), infos.end()), std::forward<std::function<void(std::unordered_map<std::string, std::optional<std::filesystem::path>>)>>(onFinished), maxConcurrency, std::forward<std::function<void(int, int)>>(progressReport)).detach();
-    }
+    /// @param stopToken when stop is requested every download of the batch that hasn't finished is cancelled
+    /// nothing waits for the batch, onFinished is called on the thread of the download that ended last, or right away when infos is empty
+    BEATSAVER_PLUSPLUS_EXPORT void DownloadBeatmapsAsync(std::span<BeatmapDownloadInfo const> infos, std::function<void(std::unordered_map<std::string, std::optional<std::filesystem::path>>)> onFinished, int maxConcurrency = 4, std::function<void(int, int)> progressReport = nullptr, std::stop_token stopToken = {});
 #pragma endregion // download
 }
 
-#define BEATSAVER_PLUSPLUS_GET(func, ...) BeatSaver::API::GetBeatsaverDownloader().Get<BeatSaver::API::BeatSaverResponse_t<&func>>(func(__VA_ARGS__))
-#define BEATSAVER_PLUSPLUS_GET_ASYNC(func, finished, ...) BeatSaver::API::GetBeatsaverDownloader().GetAsync<BeatSaver::API::BeatSaverResponse_t<&func>>(func(__VA_ARGS__), finished)
-#define BEATSAVER_PLUSPLUS_GET_FUTURE(func, ...) BeatSaver::API::GetBeatsaverDownloader().GetAsync<BeatSaver::API::BeatSaverResponse_t<&func>>(func(__VA_ARGS__))
+#define BEATSAVER_PLUSPLUS_GET(func, ...) BeatSaver::API::Fetch<BeatSaver::API::BeatSaverResponse_t<&func>>(func(__VA_ARGS__))
+#define BEATSAVER_PLUSPLUS_GET_ASYNC(func, finished, ...) BeatSaver::API::FetchAsync<BeatSaver::API::BeatSaverResponse_t<&func>>(func(__VA_ARGS__), finished)
+#define BEATSAVER_PLUSPLUS_GET_FUTURE(func, ...) BeatSaver::API::FetchAsync<BeatSaver::API::BeatSaverResponse_t<&func>>(func(__VA_ARGS__))
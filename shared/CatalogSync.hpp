@@ -0,0 +1,70 @@
+#pragma once
+
+#include "./_config.h"
+#include "./BeatSaver.hpp"
+#include "./Future.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+
+namespace BeatSaver::API {
+    /// @brief options for keeping a local copy of the map catalog up to date
+    struct BEATSAVER_PLUSPLUS_EXPORT CatalogSyncOptions {
+        /// @brief file the high-water mark is kept in, the data path's catalog_sync.json when empty. use separate files for separate mirrors
+        std::filesystem::path statePath = {};
+        /// @brief maps requested per page
+        int pageSize = 100;
+        /// @brief pages kept requested ahead of the one being applied
+        std::size_t readAhead = 1;
+        /// @brief whether to mirror auto mapped levels
+        Filter automapper = Filter::Ignore;
+        /// @brief whether to mirror maps by verified mappers
+        Filter verified = Filter::Ignore;
+    };
+
+    /// @brief how a catalog sync went
+    struct BEATSAVER_PLUSPLUS_EXPORT CatalogSyncResult {
+        /// @brief maps handed to apply
+        std::size_t changed = 0;
+        /// @brief pages received
+        std::size_t pages = 0;
+        /// @brief update time of the newest map applied, which the next sync continues after
+        std::optional<std::string> highWaterMark = std::nullopt;
+        /// @brief whether the sync caught up, false if a request failed or it was stopped. running it again resumes where this one ended
+        bool complete = false;
+        /// @brief http code of the failed request, 0 if none failed
+        long httpCode = 0;
+        /// @brief curl status of the failed request, 0 if none failed
+        int curlStatus = 0;
+    };
+
+    /// @brief walks the latest maps by update time from the persisted high-water mark, and hands every map that changed since to apply.
+    /// the mark is saved with the ids of the maps applied at its time after every page apply returned for, so an interrupted sync resumes with the first map that wasn't applied.
+    /// maps updated at the same time as the mark aren't skipped, even when they didn't fit on the page the mark came from
+    /// the first sync starts at the beginning of the catalog
+    /// @param apply called with each page of changed maps, oldest change first. a map that changed again during the sync shows up again
+    /// @param options where the mark is kept and what to request
+    /// @param stopToken stops the sync after the page being applied
+    /// @return CatalogSyncResult
+    BEATSAVER_PLUSPLUS_EXPORT CatalogSyncResult SyncCatalog(std::function<void(std::span<Models::Beatmap const>)> apply, CatalogSyncOptions options = {}, std::stop_token stopToken = {});
+
+    /// @brief SyncCatalog on its own thread, it mostly waits on the network so it doesn't take up an executor thread
+    /// @param apply called with each page of changed maps, on the sync thread
+    /// @param options where the mark is kept and what to request
+    /// @param stopToken stops the sync after the page being applied
+    /// @return Future<CatalogSyncResult>
+    BEATSAVER_PLUSPLUS_EXPORT Future<CatalogSyncResult> SyncCatalogAsync(std::function<void(std::span<Models::Beatmap const>)> apply, CatalogSyncOptions options = {}, std::stop_token stopToken = {});
+
+    /// @brief get the persisted high-water mark, nullopt if nothing was synced yet
+    /// @param statePath file the mark is kept in, the default one when empty
+    BEATSAVER_PLUSPLUS_EXPORT std::optional<std::string> GetCatalogHighWaterMark(std::filesystem::path statePath = {});
+
+    /// @brief forget the high-water mark, so the next sync starts over from the beginning of the catalog
+    /// @param statePath file the mark is kept in, the default one when empty
+    BEATSAVER_PLUSPLUS_EXPORT void ResetCatalogSync(std::filesystem::path statePath = {});
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "./_config.h"
+#include "./BeatSaver.hpp"
+#include "./DownloadManager.hpp"
+#include "./Task.hpp"
+
+#include <coroutine>
+#include <string>
+
+/// awaitable variants of the endpoints in BeatSaver.hpp. the request tasks switch to the executor and make the blocking request there,
+/// so the awaiting thread is free but an executor thread is taken for the whole transfer, at most Executor::GetInstance().GetThreadCount() of them are in flight at once.
+/// the download awaiters are the exception, they are resumed by the download manager and don't take a thread while waiting.
+/// every task takes a stop token that is handed to the endpoint it wraps
+namespace BeatSaver::API::Coro {
+    /// @brief get request as a task, what every endpoint in this header goes through
+    template<typename T>
+    Task<T> FetchTask(WebUtils::URLOptions urlOptions, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        co_await SwitchToExecutor();
+        co_return Fetch<T>(std::move(urlOptions), std::move(progressReport), stopToken);
+    }
+
+    /// @brief post request as a task
+    template<typename T>
+    Task<T> PostTask(WebUtils::URLOptions urlOptions, std::string data, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        co_await SwitchToExecutor();
+        co_return PostData<T>(std::move(urlOptions), {(uint8_t*)data.data(), data.size()}, std::move(progressReport), stopToken);
+    }
+
+    /// @brief asset request through the asset cache as a task, see API::FetchAsset
+    template<typename T>
+    Task<T> FetchAssetTask(WebUtils::URLOptions urlOptions, std::string hash, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        co_await SwitchToExecutor();
+        co_return FetchCachedAsset<T>(std::move(urlOptions), std::move(hash), std::move(progressReport), stopToken);
+    }
+
+    /// @brief batch lookup as a task, see API::FetchBatch
+    template<typename T, typename Item>
+    Task<T> FetchBatchTask(std::vector<Item> items, WebUtils::URLOptions(*makeOptions)(std::span<Item const>), progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        co_await SwitchToExecutor();
+        co_return FetchBatch<T, Item>(items, makeOptions, std::move(progressReport), stopToken);
+    }
+
+    /// @brief single lookup through the lookup batcher as a task, see API::SetLookupBatching
+    template<typename T, typename Id>
+    Task<T> LookupTask(void(*load)(Id, std::function<void(T)>), Id id, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        co_return co_await BatchedLookupAsync<T, Id>(load, std::move(id), std::move(progressReport), stopToken);
+    }
+
+    /// @brief get beatmap by key, awaitable
+    inline Task<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>> GetBeatmapByKey(std::string key, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (GetLookupBatching()) return LookupTask<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(&LoadBeatmapByKey, key, progressReport, stopToken);
+        return FetchTask<BeatSaverResponse_t<&GetBeatmapByKeyURLOptions>>(GetBeatmapByKeyURLOptions(key), progressReport, stopToken);
+    }
+
+    /// @brief get multiple beatmaps by key, awaitable
+    inline Task<BeatSaverResponse_t<&GetBeatmapsByKeysURLOptions>> GetBeatmapsByKeys(std::span<std::string const> keys, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatchTask<BeatSaverResponse_t<&GetBeatmapsByKeysURLOptions>, std::string>(std::vector(keys.begin(), keys.end()), &GetBeatmapsByKeysURLOptions, progressReport, stopToken);
+    }
+
+    /// @brief get beatmap by hash, awaitable
+    inline Task<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>> GetBeatmapByHash(std::string hash, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (GetLookupBatching()) return LookupTask<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(&LoadBeatmapByHash, hash, progressReport, stopToken);
+        return FetchTask<BeatSaverResponse_t<&GetBeatmapByHashURLOptions>>(GetBeatmapByHashURLOptions(hash), progressReport, stopToken);
+    }
+
+    /// @brief get multiple beatmaps by hash, awaitable
+    inline Task<BeatSaverResponse_t<&GetBeatmapsByHashesURLOptions>> GetBeatmapsByHashes(std::span<std::string const> hashes, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatchTask<BeatSaverResponse_t<&GetBeatmapsByHashesURLOptions>, std::string>(std::vector(hashes.begin(), hashes.end()), &GetBeatmapsByHashesURLOptions, progressReport, stopToken);
+    }
+
+    /// @brief get beatmaps uploaded by a user, awaitable
+    inline Task<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>> GetBeatmapsByUser(int id, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>>(GetBeatmapsByUserURLOptions(id, page), progressReport, stopToken);
+    }
+
+    /// @brief get collaborations of a user, awaitable
+    inline Task<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>> GetCollaborationsByUser(int id, CollaborationQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>>(GetCollaborationsByUserURLOptions(id, queryOptions), progressReport, stopToken);
+    }
+
+    /// @brief get latest beatmaps, awaitable
+    inline Task<BeatSaverResponse_t<&GetLatestURLOptions>> GetLatest(LatestQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetLatestURLOptions>>(GetLatestURLOptions(queryOptions), progressReport, stopToken);
+    }
+
+    /// @brief get most played beatmaps, awaitable
+    inline Task<BeatSaverResponse_t<&GetPlaysURLOptions>> GetPlays(int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetPlaysURLOptions>>(GetPlaysURLOptions(page), progressReport, stopToken);
+    }
+
+    /// @brief get user by id, awaitable
+    inline Task<BeatSaverResponse_t<&GetUserByIdURLOptions>> GetUserById(int id, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        if (GetLookupBatching()) return LookupTask<BeatSaverResponse_t<&GetUserByIdURLOptions>>(&LoadUserById, id, progressReport, stopToken);
+        return FetchTask<BeatSaverResponse_t<&GetUserByIdURLOptions>>(GetUserByIdURLOptions(id), progressReport, stopToken);
+    }
+
+    /// @brief get multiple users by id, awaitable
+    inline Task<BeatSaverResponse_t<&GetUsersByIdsURLOptions>> GetUsersByIds(std::span<int const> ids, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchBatchTask<BeatSaverResponse_t<&GetUsersByIdsURLOptions>, int>(std::vector(ids.begin(), ids.end()), &GetUsersByIdsURLOptions, progressReport, stopToken);
+    }
+
+    /// @brief get user by name, awaitable
+    inline Task<BeatSaverResponse_t<&GetUserByNameURLOptions>> GetUserByName(std::string userName, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetUserByNameURLOptions>>(GetUserByNameURLOptions(userName), progressReport, stopToken);
+    }
+
+    /// @brief get the avatar image of a user, awaitable
+    inline Task<BeatSaverResponse_t<&GetAvatarImageURLOptions>> GetAvatarImage(Models::UserDetail const& userDetail, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAssetTask<BeatSaverResponse_t<&GetAvatarImageURLOptions>>(GetAvatarImageURLOptions(userDetail), "", progressReport, stopToken);
+    }
+
+    /// @brief get a page of search results, awaitable
+    inline Task<BeatSaverResponse_t<&GetPageURLOptions>> GetPage(int page, SearchQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetPageURLOptions>>(GetPageURLOptions(page, queryOptions), progressReport, stopToken);
+    }
+
+    /// @brief get votes, awaitable
+    inline Task<BeatSaverResponse_t<&GetVoteURLOptions>> GetVote(VoteQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetVoteURLOptions>>(GetVoteURLOptions(queryOptions), progressReport, stopToken);
+    }
+
+    /// @brief get latest playlists, awaitable
+    inline Task<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>> GetLatestPlaylists(LatestPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetLatestPlaylistsURLOptions>>(GetLatestPlaylistsURLOptions(queryOptions), progressReport, stopToken);
+    }
+
+    /// @brief search playlists, awaitable
+    inline Task<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>> GetSearchPlaylists(int page = 0, SearchPlaylistsQueryOptions queryOptions = {}, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>>(GetSearchPlaylistsURLOptions(page, queryOptions), progressReport, stopToken);
+    }
+
+    /// @brief get playlists of a user, awaitable
+    inline Task<BeatSaverResponse_t<&GetUserPlaylistsURLOptions>> GetUserPlaylists(int userID, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetUserPlaylistsURLOptions>>(GetUserPlaylistsURLOptions(userID, page), progressReport, stopToken);
+    }
+
+    /// @brief get playlist info, awaitable
+    inline Task<BeatSaverResponse_t<&GetPlaylistURLOptions>> GetPlaylist(int playlistID, int page = 0, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchTask<BeatSaverResponse_t<&GetPlaylistURLOptions>>(GetPlaylistURLOptions(playlistID, page), progressReport, stopToken);
+    }
+
+    /// @brief get the cover image of a beatmap version, awaitable
+    inline Task<BeatSaverResponse_t<&GetCoverImageURLOptions>> GetCoverImage(Models::BeatmapVersion const& version, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAssetTask<BeatSaverResponse_t<&GetCoverImageURLOptions>>(GetCoverImageURLOptions(version), version.Hash, progressReport, stopToken);
+    }
+
+    /// @brief get the preview audio of a beatmap version, awaitable
+    inline Task<BeatSaverResponse_t<&GetPreviewURLOptions>> GetPreview(Models::BeatmapVersion const& version, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        return FetchAssetTask<BeatSaverResponse_t<&GetPreviewURLOptions>>(GetPreviewURLOptions(version), version.Hash, progressReport, stopToken);
+    }
+
+    /// @brief post verification request, awaitable
+    inline Task<BeatSaverResponse_t<&PostVerifyURLOptionsAndData>> PostVerify(PlatformAuth auth, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        auto [url, data] = PostVerifyURLOptionsAndData(auth);
+        return PostTask<BeatSaverResponse_t<&PostVerifyURLOptionsAndData>>(std::move(url), std::move(data), progressReport, stopToken);
+    }
+
+    /// @brief post a vote, awaitable
+    inline Task<BeatSaverResponse_t<&PostVoteURLOptionsAndData>> PostVote(PlatformAuth auth, bool direction, std::string hash, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        auto [url, data] = PostVoteURLOptionsAndData(auth, direction, hash);
+        return PostTask<BeatSaverResponse_t<&PostVoteURLOptionsAndData>>(std::move(url), std::move(data), progressReport, stopToken);
+    }
+
+    /// @brief awaiter that queues a download in the download manager and resumes once the manager reports it finished
+    struct DownloadBeatmapAwaiter {
+        BeatmapDownloadInfo info;
+        DownloadPriority priority;
+        progress_function progressReport;
+        /// @brief cancels the download in the manager, which resumes the coroutine with nullopt
+        std::stop_token stopToken;
+        std::optional<std::filesystem::path> result = std::nullopt;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            DownloadManager::GetInstance().Enqueue(info, priority, [this, handle](std::optional<std::filesystem::path> path) {
+                result = std::move(path);
+                handle.resume();
+            }, progressReport, stopToken);
+        }
+        std::optional<std::filesystem::path> await_resume() { return std::move(result); }
+    };
+
+    /// @brief download a beatmap through the download manager, awaitable
+    /// @return optional path, if set the download was succesful and the map can be found @ that path, nullopt if failed
+    inline Task<std::optional<std::filesystem::path>> DownloadBeatmap(BeatmapDownloadInfo info, DownloadPriority priority = DownloadPriority::High, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        co_return co_await DownloadBeatmapAwaiter{std::move(info), priority, std::move(progressReport), stopToken};
+    }
+
+    /// @brief suspends until every download of a batch ended, resumed on the thread of the one that ended last
+    struct DownloadBeatmapsAwaiter {
+        std::vector<BeatmapDownloadInfo> infos;
+        int maxConcurrency;
+        std::function<void(int, int)> progressReport;
+        std::stop_token stopToken;
+        std::unordered_map<std::string, std::optional<std::filesystem::path>> results;
+
+        bool await_ready() const noexcept { return infos.empty(); }
+        void await_suspend(std::coroutine_handle<> handle) {
+            // the last download may resume the coroutine and take this awaiter with it before DownloadBeatmapsAsync returns
+            auto batch = std::move(infos);
+            API::DownloadBeatmapsAsync(batch, [this, handle](std::unordered_map<std::string, std::optional<std::filesystem::path>> batchResults) {
+                results = std::move(batchResults);
+                handle.resume();
+            }, maxConcurrency, std::move(progressReport), stopToken);
+        }
+        std::unordered_map<std::string, std::optional<std::filesystem::path>> await_resume() { return std::move(results); }
+    };
+
+    /// @brief download multiple beatmaps through the download manager, awaitable. no thread waits for the batch
+    /// @return map of beatmap keys to path results, see API::DownloadBeatmaps
+    inline Task<std::unordered_map<std::string, std::optional<std::filesystem::path>>> DownloadBeatmaps(std::vector<BeatmapDownloadInfo> infos, int maxConcurrency = 4, std::function<void(int, int)> progressReport = nullptr, std::stop_token stopToken = {}) {
+        co_return co_await DownloadBeatmapsAwaiter{std::move(infos), maxConcurrency, std::move(progressReport), stopToken};
+    }
+
+    /// @brief downloads a song zip from the url and extracts it to a given path, awaitable
+    inline Task<bool> DownloadSongZip(WebUtils::URLOptions urlOptions, std::filesystem::path outputPath, progress_function progressReport = nullptr, std::stop_token stopToken = {}) {
+        co_await SwitchToExecutor();
+        co_return API::DownloadSongZip(std::move(urlOptions), std::move(outputPath), std::move(progressReport), stopToken);
+    }
+}
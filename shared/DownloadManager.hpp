@@ -0,0 +1,202 @@
+#pragma once
+
+#include "./_config.h"
+#include "BeatSaver.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stop_token>
+#include <vector>
+
+namespace BeatSaver::API {
+    /// @brief priority of a queued download, higher priorities are started first
+    enum class DownloadPriority {
+        /// @brief background work, like installing a whole playlist
+        Low,
+        Normal,
+        /// @brief something a user is waiting for, like a single click to play download
+        High,
+    };
+
+    enum class DownloadState {
+        /// @brief waiting for a free download slot
+        Queued,
+        /// @brief won't be started until it is resumed. a download paused while running keeps its partial zip and continues from there
+        Paused,
+        Downloading,
+        /// @brief downloaded and installed, the result has the path
+        Finished,
+        Failed,
+        Cancelled,
+    };
+
+    /// @brief snapshot of the state of a download in the download manager
+    struct BEATSAVER_PLUSPLUS_EXPORT DownloadStatus {
+        uint64_t id;
+        std::string key;
+        DownloadPriority priority;
+        DownloadState state;
+        /// @brief progress of the download 0-1
+        float progress;
+        /// @brief where the map was installed, only set once the state is Finished
+        std::optional<std::filesystem::path> result;
+    };
+
+    /// @brief long lived queue of beatmap downloads, shares one concurrency budget between every caller
+    class BEATSAVER_PLUSPLUS_EXPORT DownloadManager {
+        public:
+            using DownloadId = uint64_t;
+
+            /// @brief limit on how many downloads of a group run at once, on top of the global limit
+            struct Group {
+                int maxConcurrency;
+                int running = 0;
+            };
+
+            /// @brief get the download manager that DownloadBeatmapAsync and DownloadBeatmaps go through
+            static DownloadManager& GetInstance();
+
+            /// @brief queues a beatmap download
+            /// @param info the download info for the map to download
+            /// @param priority downloads with a higher priority are started first, equal priorities start in the order they were queued
+            /// @param onFinished called once the download finished, failed or was cancelled. nullopt if it didn't install
+            /// @param progressReport method called to report download progress, void(float) 0-1
+            /// @param stopToken when stop is requested the download is cancelled, like Cancel does
+            /// @return id to refer to the download with
+            DownloadId Enqueue(BeatmapDownloadInfo info, DownloadPriority priority = DownloadPriority::Normal, finished_opt_function<std::filesystem::path> onFinished = nullptr, progress_function progressReport = nullptr, std::stop_token stopToken = {});
+
+            /// @brief keeps the download from starting, or stops it at the next chunk if it is running. the partial zip is kept for when it is resumed
+            /// @return false if the download is unknown or already done
+            bool Pause(DownloadId id);
+
+            /// @brief queues a paused download again
+            /// @return false if the download is unknown or not paused
+            bool Resume(DownloadId id);
+
+            /// @brief cancels a queued or paused download, or stops it at the next chunk if it is running
+            /// @return false if the download is unknown or already done
+            bool Cancel(DownloadId id);
+
+            /// @brief changes the priority of a download that has not started yet
+            /// @return false if the download is unknown or already done
+            bool SetPriority(DownloadId id, DownloadPriority priority);
+
+            /// @brief get the current state of a download, nullopt if the id is unknown or was cleared.
+            /// downloads that finished, failed or were cancelled are only remembered until 64 more have
+            std::optional<DownloadStatus> GetStatus(DownloadId id) const;
+
+            /// @brief get the current state of every download that is queued, paused or running, followed by the ones that ended most recently
+            std::vector<DownloadStatus> GetStatuses() const;
+
+            /// @brief forgets about the remembered downloads that finished, failed or were cancelled
+            void ClearFinished();
+
+            /// @brief set how many downloads may run at the same time across every caller
+            void SetMaxConcurrency(int maxConcurrency);
+
+            /// @brief get how many downloads may run at the same time across every caller, defaults to 4
+            int GetMaxConcurrency() const;
+
+            /// @brief lets the manager pick how many downloads run at once, between 1 and GetMaxConcurrency.
+            /// it adds a download while that raises the measured throughput, and halves on 429/503 responses or when time to first byte climbs
+            void SetAdaptiveConcurrency(bool enabled);
+
+            /// @brief whether adaptive concurrency is enabled, defaults to false
+            bool GetAdaptiveConcurrency() const;
+
+            /// @brief get how many downloads may currently run at once, the adaptively chosen value if adaptive concurrency is enabled
+            int GetCurrentConcurrency() const;
+
+            /// @brief feeds a finished request into the adaptive concurrency, DownloadToFile calls this for every chunk
+            /// @param bytes amount of bytes received
+            /// @param timeToFirstByte time until the first progress was reported, or the whole duration if there was none
+            /// @param duration time the whole request took
+            /// @param httpCode http code of the response, 0 if there was none
+            void ReportTransfer(std::size_t bytes, std::chrono::steady_clock::duration timeToFirstByte, std::chrono::steady_clock::duration duration, long httpCode);
+
+            /// @brief queues a download that counts against the given group's concurrency limit, used by DownloadBeatmaps to keep its maxConcurrency
+            DownloadId Enqueue(BeatmapDownloadInfo info, DownloadPriority priority, std::shared_ptr<Group> group, finished_opt_function<std::filesystem::path> onFinished = nullptr, progress_function progressReport = nullptr, std::stop_token stopToken = {});
+        private:
+            DownloadManager() = default;
+
+            using StopCallback = std::stop_callback<std::function<void()>>;
+
+            struct Item {
+                DownloadId id;
+                BeatmapDownloadInfo info;
+                DownloadPriority priority;
+                uint64_t sequence;
+                DownloadState state = DownloadState::Queued;
+                float progress = 0;
+                std::optional<std::filesystem::path> result = std::nullopt;
+                std::shared_ptr<Group> group;
+                finished_opt_function<std::filesystem::path> onFinished;
+                progress_function progressReport;
+                std::stop_source stopSource;
+                bool pauseRequested = false;
+                /// @brief cancels the item when the caller's stop token is stopped. it has to be destroyed without holding the mutex, as it may be waiting on it
+                std::unique_ptr<StopCallback> onStop = nullptr;
+            };
+
+            /// @brief orders the queue, highest priority first and the earliest queued first within a priority
+            struct QueueOrder {
+                bool operator()(std::shared_ptr<Item> const& lhs, std::shared_ptr<Item> const& rhs) const {
+                    if (lhs->priority != rhs->priority) return lhs->priority > rhs->priority;
+                    return lhs->sequence < rhs->sequence;
+                }
+            };
+
+            void Work();
+            /// @brief picks the next item to start and takes it out of the queue, expects the mutex to be held
+            std::shared_ptr<Item> TakeNext();
+            /// @brief forgets an item that ended, only its status is kept around for a while. expects the mutex to be held
+            void Retire(Item const& item);
+            /// @brief starts workers until there is one per allowed concurrent download, expects the mutex to be held
+            void SpawnWorkers();
+            /// @brief how many downloads may run right now, expects the mutex to be held
+            int GetConcurrencyLimit() const;
+            /// @brief whether any item is waiting for a free slot, expects the mutex to be held
+            bool HasQueued() const;
+            /// @brief changes the adaptive limit and wakes the workers up to match it, expects the mutex to be held
+            void SetAdaptiveLimit(int limit);
+            static DownloadStatus ToStatus(Item const& item);
+
+            mutable std::mutex mutex;
+            std::condition_variable itemsChanged;
+            /// @brief items that are queued, paused or running
+            std::map<DownloadId, std::shared_ptr<Item>> items;
+            /// @brief the queued items, the order they start in. an item's priority only changes while it's out of here
+            std::set<std::shared_ptr<Item>, QueueOrder> queue;
+            /// @brief the statuses of the items that ended most recently, oldest first
+            std::deque<DownloadStatus> recent;
+            DownloadId nextId = 1;
+            uint64_t nextSequence = 0;
+            int maxConcurrency = 4;
+            int workerCount = 0;
+
+            /// @brief state of the adaptive concurrency, all of it is measured over one window of transfers at a time
+            struct Adaptive {
+                bool enabled = false;
+                int limit = 2;
+                /// @brief whether the last change was an increase, so a drop in throughput after it can be undone
+                bool lastChangeWasIncrease = false;
+                std::chrono::steady_clock::time_point windowStart = std::chrono::steady_clock::now();
+                std::chrono::steady_clock::time_point lastDecrease = {};
+                std::size_t windowBytes = 0;
+                std::chrono::steady_clock::duration windowTimeToFirstByte = {};
+                int windowTransfers = 0;
+                double previousThroughput = 0;
+                /// @brief lowest average time to first byte seen, what an uncongested link looks like
+                std::optional<std::chrono::steady_clock::duration> baseTimeToFirstByte = std::nullopt;
+            } adaptive;
+    };
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "./_config.h"
+#include "./Future.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+namespace BeatSaver::API {
+    /// @brief bounded pool of threads that every async entry point of beatsaverplusplus runs on, instead of a thread per call
+    class BEATSAVER_PLUSPLUS_EXPORT Executor {
+        public:
+            /// @brief get the executor the library's async methods run on
+            static Executor& GetInstance();
+
+            /// @brief whether the calling thread is one of the executor's threads
+            static bool IsExecutorThread();
+
+            /// @brief queues a task, never blocks. if the queue is full and the caller is one of the executor's own threads the task runs right away on it,
+            /// so nested tasks can't pile up or deadlock. any other caller, like the main thread, gets its task queued past the limit instead of waiting
+            void Post(std::function<void()> task);
+
+            /// @brief runs a task once the delay is over, on the executor's timer thread so it doesn't wait for a worker to be free.
+            /// delayed tasks run one after the other, a long one holds back the ones due after it
+            void PostDelayed(std::chrono::milliseconds delay, std::function<void()> task);
+
+            /// @brief queues a callable and gets a future for its result, queueing works like Post
+            template<typename F>
+            auto Submit(F&& func) -> Future<std::invoke_result_t<std::decay_t<F>>> {
+                using R = std::invoke_result_t<std::decay_t<F>>;
+                // std::function needs a copyable callable, func may be move only
+                auto task = std::make_shared<std::decay_t<F>>(std::forward<F>(func));
+                Promise<R> promise;
+                auto future = promise.GetFuture();
+                Post([task, promise]() mutable {
+                    try {
+                        if constexpr (std::is_void_v<R>) {
+                            (*task)();
+                            promise.SetValue();
+                        } else {
+                            promise.SetValue((*task)());
+                        }
+                    } catch (...) {
+                        promise.SetException(std::current_exception());
+                    }
+                });
+                return future;
+            }
+
+            /// @brief set how many threads run tasks at most, threads are started as work comes in
+            void SetThreadCount(int threadCount);
+
+            /// @brief get how many threads run tasks at most, defaults to 8
+            int GetThreadCount() const;
+
+            /// @brief set how many tasks may wait in the queue before the executor's own threads run what they post themselves, see Post
+            void SetMaxQueueSize(std::size_t maxQueueSize);
+
+            /// @brief get how many tasks may wait in the queue before the executor's own threads run what they post themselves, defaults to 256
+            std::size_t GetMaxQueueSize() const;
+        private:
+            Executor() = default;
+
+            void Work();
+            /// @brief what the timer thread runs, it runs the delayed tasks as they become due
+            void KeepTime();
+
+            mutable std::mutex mutex;
+            std::condition_variable taskAdded;
+            std::deque<std::function<void()>> tasks;
+            std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> delayedTasks;
+            std::condition_variable delayedChanged;
+            bool timerRunning = false;
+            int threadCount = 8;
+            std::size_t maxQueueSize = 256;
+            /// @brief whether the queue went over the limit, so the warning is logged once each time it does
+            bool overflowing = false;
+            int workerCount = 0;
+            int idleCount = 0;
+    };
+}
@@ -0,0 +1,411 @@
+#pragma once
+
+#include "./_config.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace BeatSaver::API {
+    template<typename T>
+    class Future;
+
+    template<typename T>
+    class Promise;
+
+    namespace Detail {
+        /// @brief what a future stores, void futures store nothing
+        template<typename T>
+        using FutureValue = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        template<typename T>
+        struct FutureState {
+            std::mutex mutex;
+            std::condition_variable_any finished;
+            bool ready = false;
+            std::optional<FutureValue<T>> value = std::nullopt;
+            std::exception_ptr exception = nullptr;
+            /// @brief runs once the state is ready. there is at most one, continuing a future consumes it
+            std::function<void()> continuation = nullptr;
+
+            /// @brief sets the result with setResult and runs the continuation, false if the state was ready already
+            template<typename F>
+            bool Complete(F&& setResult) {
+                std::function<void()> next = nullptr;
+                {
+                    std::unique_lock lock(mutex);
+                    if (ready) return false;
+                    setResult();
+                    ready = true;
+                    next = std::move(continuation);
+                    finished.notify_all();
+                }
+                if (next) next();
+                return true;
+            }
+
+            /// @brief runs func once the state is ready, right away if it is already
+            void Continue(std::function<void()> func) {
+                {
+                    std::unique_lock lock(mutex);
+                    if (!ready) {
+                        continuation = std::move(func);
+                        return;
+                    }
+                }
+                func();
+            }
+        };
+
+        /// @brief breaks the promise once the last copy of it is gone without a result, so waiting on its future can't hang forever
+        template<typename T>
+        struct PromiseOwner {
+            std::shared_ptr<FutureState<T>> state;
+
+            ~PromiseOwner() {
+                state->Complete([this]() { state->exception = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)); });
+            }
+        };
+
+        template<typename T>
+        struct IsFuture : std::false_type {};
+
+        template<typename T>
+        struct IsFuture<Future<T>> : std::true_type {
+            using ValueType = T;
+        };
+
+        template<typename T, typename F>
+        struct ContinuationResult {
+            using type = std::invoke_result_t<F, T>;
+        };
+
+        template<typename F>
+        struct ContinuationResult<void, F> {
+            using type = std::invoke_result_t<F>;
+        };
+
+        /// @brief lets the combinators below reach into futures without making them public
+        struct FutureAccess {
+            template<typename T>
+            static std::shared_ptr<FutureState<T>> TakeState(Future<T>&& future) {
+                future.CheckState();
+                return std::move(future.state);
+            }
+        };
+
+        /// @brief completes promise with whatever state ends up holding
+        template<typename T>
+        void ForwardInto(std::shared_ptr<FutureState<T>> state, Promise<T> promise) {
+            state->Continue([state, promise]() mutable {
+                if (state->exception) promise.SetException(state->exception);
+                else if constexpr (std::is_void_v<T>) promise.SetValue();
+                else promise.SetValue(std::move(state->value.value()));
+            });
+        }
+    }
+
+    /// @brief the producing side of a Future, copies of a promise complete the same future
+    template<typename T>
+    class Promise {
+        public:
+            Promise() : owner(std::make_shared<Detail::PromiseOwner<T>>(std::make_shared<Detail::FutureState<T>>())) {}
+
+            /// @brief get the future this promise completes, only call this once
+            Future<T> GetFuture() { return Future<T>(owner->state); }
+
+            /// @brief completes the future with a value
+            /// @return false if the future was completed already
+            template<typename... Args>
+            bool SetValue(Args&&... args) {
+                auto& state = *owner->state;
+                return state.Complete([&]() { state.value.emplace(std::forward<Args>(args)...); });
+            }
+
+            /// @brief completes the future with an exception, get() rethrows it
+            /// @return false if the future was completed already
+            bool SetException(std::exception_ptr exception) {
+                auto& state = *owner->state;
+                return state.Complete([&]() { state.exception = exception; });
+            }
+        private:
+            std::shared_ptr<Detail::PromiseOwner<T>> owner;
+    };
+
+    /// @brief result of an async call that can be continued instead of waited on.
+    /// get, wait and wait_for behave like they do on std::future, and it converts to a std::future for code that wants one.
+    /// like on std::future, using a future that isn't valid() throws a std::future_error with std::future_errc::no_state.
+    /// continuations run on the thread that completes the future, so keep them short or hand heavy work to the executor
+    template<typename T>
+    class [[nodiscard]] Future {
+        public:
+            using ValueType = T;
+
+            Future() = default;
+            Future(Future&&) noexcept = default;
+            Future& operator=(Future&&) noexcept = default;
+            Future(Future const&) = delete;
+            Future& operator=(Future const&) = delete;
+
+            /// @brief whether this future still refers to a result, false after get, Then or converting it
+            bool valid() const noexcept { return state != nullptr; }
+
+            /// @brief whether the result is there, get won't block if it is
+            bool IsReady() const {
+                CheckState();
+                std::unique_lock lock(state->mutex);
+                return state->ready;
+            }
+
+            /// @brief blocks until the result is there
+            void wait() const {
+                CheckState();
+                std::unique_lock lock(state->mutex);
+                state->finished.wait(lock, [this]() { return state->ready; });
+            }
+
+            /// @brief blocks until the result is there or stop is requested
+            /// @return whether the result is there
+            bool wait(std::stop_token stopToken) const {
+                CheckState();
+                std::unique_lock lock(state->mutex);
+                return state->finished.wait(lock, stopToken, [this]() { return state->ready; });
+            }
+
+            /// @brief blocks until the result is there or the timeout passed
+            template<typename Rep, typename Period>
+            std::future_status wait_for(std::chrono::duration<Rep, Period> const& timeout) const {
+                CheckState();
+                std::unique_lock lock(state->mutex);
+                return state->finished.wait_for(lock, timeout, [this]() { return state->ready; }) ? std::future_status::ready : std::future_status::timeout;
+            }
+
+            /// @brief blocks until the result is there and takes it, rethrows if the future failed
+            T get() {
+                wait();
+                auto finished = std::move(state);
+                if (finished->exception) std::rethrow_exception(finished->exception);
+                if constexpr (!std::is_void_v<T>) return std::move(finished->value.value());
+            }
+
+            /// @brief runs func with the result once it's there, without blocking anyone while waiting.
+            /// a failed future skips func and hands its exception on. if func returns a Future, the returned future waits for that one too
+            /// @param func void(T) or R(T), for a void future it takes no arguments
+            /// @return future for what func returns
+            template<typename F>
+            auto Then(F&& func) {
+                using R = typename Detail::ContinuationResult<T, std::decay_t<F>>::type;
+                if constexpr (Detail::IsFuture<R>::value) {
+                    using U = typename Detail::IsFuture<R>::ValueType;
+                    return Continue<U>(std::forward<F>(func), [](auto& call, Promise<U>& promise) {
+                        Detail::ForwardInto(Detail::FutureAccess::TakeState(call()), promise);
+                    });
+                } else {
+                    return Continue<R>(std::forward<F>(func), [](auto& call, Promise<R>& promise) {
+                        if constexpr (std::is_void_v<R>) {
+                            call();
+                            promise.SetValue();
+                        } else {
+                            promise.SetValue(call());
+                        }
+                    });
+                }
+            }
+
+            // co_await a future to resume the coroutine on the thread that completes it
+            bool await_ready() const { return IsReady(); }
+            void await_suspend(std::coroutine_handle<> handle) {
+                CheckState();
+                // the coroutine, and this future with it, may be gone once it's resumed
+                auto source = state;
+                source->Continue([handle]() { handle.resume(); });
+            }
+            T await_resume() { return get(); }
+
+            /// @brief hands the result over to a std::future, for code written against the standard type
+            operator std::future<T>() && {
+                CheckState();
+                auto promise = std::make_shared<std::promise<T>>();
+                auto future = promise->get_future();
+                auto source = std::move(state);
+                source->Continue([source, promise]() {
+                    if (source->exception) promise->set_exception(source->exception);
+                    else if constexpr (std::is_void_v<T>) promise->set_value();
+                    else promise->set_value(std::move(source->value.value()));
+                });
+                return future;
+            }
+        private:
+            friend class Promise<T>;
+            friend struct Detail::FutureAccess;
+
+            explicit Future(std::shared_ptr<Detail::FutureState<T>> state) : state(std::move(state)) {}
+
+            /// @brief throws like std::future does when the future was default constructed, moved from or already consumed
+            void CheckState() const {
+                if (!state) throw std::future_error(std::future_errc::no_state);
+            }
+
+            /// @brief shared part of Then, complete gets a callable running func on the result and the promise to complete
+            template<typename U, typename F, typename C>
+            Future<U> Continue(F&& func, C complete) {
+                CheckState();
+                Promise<U> promise;
+                auto future = promise.GetFuture();
+                auto source = std::move(state);
+                source->Continue([source, promise, func = std::forward<F>(func), complete]() mutable {
+                    if (source->exception) {
+                        promise.SetException(source->exception);
+                        return;
+                    }
+
+                    auto call = [&]() -> decltype(auto) {
+                        if constexpr (std::is_void_v<T>) return func();
+                        else return func(std::move(source->value.value()));
+                    };
+                    try {
+                        complete(call, promise);
+                    } catch (...) {
+                        promise.SetException(std::current_exception());
+                    }
+                });
+                return future;
+            }
+
+            std::shared_ptr<Detail::FutureState<T>> state = nullptr;
+    };
+
+    /// @brief future that is done once every one of futures is, with their results in the same order.
+    /// if any of them failed it fails with the first exception, after all of them finished
+    template<typename T>
+    auto WhenAll(std::vector<Future<T>> futures) {
+        using Result = std::conditional_t<std::is_void_v<T>, void, std::vector<Detail::FutureValue<T>>>;
+        struct Shared {
+            std::mutex mutex;
+            std::vector<std::optional<Detail::FutureValue<T>>> results;
+            std::size_t remaining;
+            std::exception_ptr exception = nullptr;
+            Promise<Result> promise;
+        };
+
+        auto shared = std::make_shared<Shared>();
+        auto future = shared->promise.GetFuture();
+        shared->results.resize(futures.size());
+        shared->remaining = futures.size();
+
+        auto finish = [](Shared& shared) {
+            if (shared.exception) shared.promise.SetException(shared.exception);
+            else if constexpr (std::is_void_v<T>) shared.promise.SetValue();
+            else {
+                std::vector<T> values;
+                values.reserve(shared.results.size());
+                for (auto& result : shared.results) values.emplace_back(std::move(result.value()));
+                shared.promise.SetValue(std::move(values));
+            }
+        };
+
+        if (futures.empty()) {
+            finish(*shared);
+            return future;
+        }
+
+        for (std::size_t i = 0; i < futures.size(); i++) {
+            auto state = Detail::FutureAccess::TakeState(std::move(futures[i]));
+            state->Continue([shared, state, i, finish]() {
+                bool last;
+                {
+                    std::unique_lock lock(shared->mutex);
+                    if (state->exception) {
+                        if (!shared->exception) shared->exception = state->exception;
+                    } else {
+                        shared->results[i] = std::move(state->value);
+                    }
+                    last = --shared->remaining == 0;
+                }
+                if (last) finish(*shared);
+            });
+        }
+        return future;
+    }
+
+    /// @brief future that is done once every one of futures is, with their results as a tuple. void futures contribute a std::monostate.
+    /// if any of them failed it fails with the first exception, after all of them finished
+    template<typename... Ts>
+    requires(sizeof...(Ts) > 0)
+    Future<std::tuple<Detail::FutureValue<Ts>...>> WhenAll(Future<Ts>... futures) {
+        using Result = std::tuple<Detail::FutureValue<Ts>...>;
+        struct Shared {
+            std::mutex mutex;
+            std::tuple<std::optional<Detail::FutureValue<Ts>>...> results;
+            std::size_t remaining = sizeof...(Ts);
+            std::exception_ptr exception = nullptr;
+            Promise<Result> promise;
+        };
+
+        auto shared = std::make_shared<Shared>();
+        auto future = shared->promise.GetFuture();
+
+        auto attach = [&shared]<std::size_t I, typename T>(std::integral_constant<std::size_t, I>, Future<T>&& source) {
+            auto state = Detail::FutureAccess::TakeState(std::move(source));
+            state->Continue([shared, state]() {
+                bool last;
+                {
+                    std::unique_lock lock(shared->mutex);
+                    if (state->exception) {
+                        if (!shared->exception) shared->exception = state->exception;
+                    } else {
+                        std::get<I>(shared->results) = std::move(state->value);
+                    }
+                    last = --shared->remaining == 0;
+                }
+                if (!last) return;
+
+                if (shared->exception) shared->promise.SetException(shared->exception);
+                else shared->promise.SetValue(std::apply([](auto&... results) { return Result(std::move(results.value())...); }, shared->results));
+            });
+        };
+
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (attach(std::integral_constant<std::size_t, I>{}, std::move(futures)), ...);
+        }(std::index_sequence_for<Ts...>{});
+        return future;
+    }
+
+    /// @brief result of WhenAny, which of the futures finished first and its result
+    template<typename T>
+    struct WhenAnyResult {
+        std::size_t index;
+        Detail::FutureValue<T> value;
+    };
+
+    /// @brief future that is done as soon as the first of futures is, with that one's index and result, or its exception.
+    /// the others keep running, their results are dropped. an empty vector gives a broken promise
+    template<typename T>
+    Future<WhenAnyResult<T>> WhenAny(std::vector<Future<T>> futures) {
+        Promise<WhenAnyResult<T>> promise;
+        auto future = promise.GetFuture();
+
+        for (std::size_t i = 0; i < futures.size(); i++) {
+            auto state = Detail::FutureAccess::TakeState(std::move(futures[i]));
+            // only the first one to finish gets to complete the promise, for the rest SetValue does nothing
+            state->Continue([promise, state, i]() mutable {
+                if (state->exception) promise.SetException(state->exception);
+                else promise.SetValue(WhenAnyResult<T>{i, std::move(state->value.value())});
+            });
+        }
+        return future;
+    }
+}
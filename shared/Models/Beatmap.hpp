@@ -18,44 +18,48 @@ SERDE_STRUCT(BeatSaver::Models, Beatmap,
     BEATSAVER_PLUSPLUS_GETTER_FIELD(bool, Ranked, "ranked");
     BEATSAVER_PLUSPLUS_GETTER_FIELD(bool, Qualified, "qualified");
     BEATSAVER_PLUSPLUS_GETTER_FIELD(std::vector<BeatmapVersion>, Versions, "versions");
+    BEATSAVER_PLUSPLUS_GETTER_FIELD_OPTIONAL(std::string, CreatedAt, "createdAt"); // datetime
+    BEATSAVER_PLUSPLUS_GETTER_FIELD_OPTIONAL(std::string, UpdatedAt, "updatedAt"); // datetime
+    BEATSAVER_PLUSPLUS_GETTER_FIELD_OPTIONAL(std::string, LastPublishedAt, "lastPublishedAt"); // datetime
+    BEATSAVER_PLUSPLUS_GETTER_FIELD_OPTIONAL(std::string, CuratedAt, "curatedAt"); // datetime
 
     public:
         BEATSAVER_PLUSPLUS_EXPORT std::string CreateFolderName(const BeatmapVersion& version) const { return fmt::format("{} ({} - {})", version.Key.value_or(Id), Metadata.SongName, Metadata.LevelAuthorName); }
         std::string CreateFolderName() const { return CreateFolderName(Versions.front()); }
 
-        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::filesystem::path> DownloadLatestBeatmap(Beatmap const& beatmap, std::function<void(float)> progressReport) const {
-            return Versions.front().DownloadBeatmap(*this, progressReport);
+        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::filesystem::path> DownloadLatestBeatmap(Beatmap const& beatmap, std::function<void(float)> progressReport, std::stop_token stopToken = {}) const {
+            return Versions.front().DownloadBeatmap(*this, progressReport, stopToken);
         }
 
-        BEATSAVER_PLUSPLUS_EXPORT std::future<std::optional<std::filesystem::path>> DownloadLatestBeatmapAsync(Beatmap const& beatmap, std::function<void(float)> progressReport) const {
-            return Versions.front().DownloadBeatmapAsync(*this, progressReport);
+        BEATSAVER_PLUSPLUS_EXPORT BeatSaver::API::Future<std::optional<std::filesystem::path>> DownloadLatestBeatmapAsync(Beatmap const& beatmap, std::function<void(float)> progressReport, std::stop_token stopToken = {}) const {
+            return Versions.front().DownloadBeatmapAsync(*this, progressReport, stopToken);
         }
 
-        BEATSAVER_PLUSPLUS_EXPORT void DownloadLatestBeatmapAsync(Beatmap const& beatmap, std::function<void(std::optional<std::filesystem::path>)> onFinished, std::function<void(float)> progressReport) const {
-            return Versions.front().DownloadBeatmapAsync(*this, onFinished, progressReport);
+        BEATSAVER_PLUSPLUS_EXPORT void DownloadLatestBeatmapAsync(Beatmap const& beatmap, std::function<void(std::optional<std::filesystem::path>)> onFinished, std::function<void(float)> progressReport, std::stop_token stopToken = {}) const {
+            return Versions.front().DownloadBeatmapAsync(*this, onFinished, progressReport, stopToken);
         }
 
-        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::vector<uint8_t>> GetLatestCoverImage() const {
-            return Versions.front().GetCoverImage();
+        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::vector<uint8_t>> GetLatestCoverImage(std::stop_token stopToken = {}) const {
+            return Versions.front().GetCoverImage(stopToken);
         }
 
-        BEATSAVER_PLUSPLUS_EXPORT void GetLatestCoverImageAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished) const {
-            return Versions.front().GetCoverImageAsync(onFinished);
+        BEATSAVER_PLUSPLUS_EXPORT void GetLatestCoverImageAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished, std::stop_token stopToken = {}) const {
+            return Versions.front().GetCoverImageAsync(onFinished, stopToken);
         }
 
-        BEATSAVER_PLUSPLUS_EXPORT std::future<std::optional<std::vector<uint8_t>>> GetLatestCoverImageAsync() const {
-            return Versions.front().GetCoverImageAsync();
+        BEATSAVER_PLUSPLUS_EXPORT BeatSaver::API::Future<std::optional<std::vector<uint8_t>>> GetLatestCoverImageAsync(std::stop_token stopToken = {}) const {
+            return Versions.front().GetCoverImageAsync(stopToken);
         }
 
-        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::vector<uint8_t>> GetLatestPreview() const {
-            return Versions.front().GetPreview();
+        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::vector<uint8_t>> GetLatestPreview(std::stop_token stopToken = {}) const {
+            return Versions.front().GetPreview(stopToken);
         }
 
-        BEATSAVER_PLUSPLUS_EXPORT void GetLatestPreviewAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished) const {
-            return Versions.front().GetPreviewAsync(onFinished);
+        BEATSAVER_PLUSPLUS_EXPORT void GetLatestPreviewAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished, std::stop_token stopToken = {}) const {
+            return Versions.front().GetPreviewAsync(onFinished, stopToken);
         }
 
-        BEATSAVER_PLUSPLUS_EXPORT std::future<std::optional<std::vector<uint8_t>>> GetLatestPreviewAsync() const {
-            return Versions.front().GetPreviewAsync();
+        BEATSAVER_PLUSPLUS_EXPORT BeatSaver::API::Future<std::optional<std::vector<uint8_t>>> GetLatestPreviewAsync(std::stop_token stopToken = {}) const {
+            return Versions.front().GetPreviewAsync(stopToken);
         }
 );
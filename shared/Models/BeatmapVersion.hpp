@@ -2,7 +2,8 @@
 
 #include "../macros.hpp"
 #include "./BeatmapDifficulty.hpp"
-#include <future>
+#include "../Future.hpp"
+#include <stop_token>
 
 namespace BeatSaver::Models {
     struct Beatmap;
@@ -21,15 +22,15 @@ SERDE_STRUCT(BeatSaver::Models, BeatmapVersion,
     BEATSAVER_PLUSPLUS_GETTER_FIELD(std::string, PreviewURL, "previewURL");
 
     public:
-        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::filesystem::path> DownloadBeatmap(Beatmap const& beatmap, std::function<void(float)> progressReport) const;
-        BEATSAVER_PLUSPLUS_EXPORT std::future<std::optional<std::filesystem::path>> DownloadBeatmapAsync(Beatmap const& beatmap, std::function<void(float)> progressReport) const;
-        BEATSAVER_PLUSPLUS_EXPORT void DownloadBeatmapAsync(Beatmap const& beatmap, std::function<void(std::optional<std::filesystem::path>)> onFinished, std::function<void(float)> progressReport) const;
+        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::filesystem::path> DownloadBeatmap(Beatmap const& beatmap, std::function<void(float)> progressReport, std::stop_token stopToken = {}) const;
+        BEATSAVER_PLUSPLUS_EXPORT BeatSaver::API::Future<std::optional<std::filesystem::path>> DownloadBeatmapAsync(Beatmap const& beatmap, std::function<void(float)> progressReport, std::stop_token stopToken = {}) const;
+        BEATSAVER_PLUSPLUS_EXPORT void DownloadBeatmapAsync(Beatmap const& beatmap, std::function<void(std::optional<std::filesystem::path>)> onFinished, std::function<void(float)> progressReport, std::stop_token stopToken = {}) const;
 
-        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::vector<uint8_t>> GetCoverImage() const;
-        BEATSAVER_PLUSPLUS_EXPORT void GetCoverImageAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished) const;
-        BEATSAVER_PLUSPLUS_EXPORT std::future<std::optional<std::vector<uint8_t>>> GetCoverImageAsync() const;
+        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::vector<uint8_t>> GetCoverImage(std::stop_token stopToken = {}) const;
+        BEATSAVER_PLUSPLUS_EXPORT void GetCoverImageAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished, std::stop_token stopToken = {}) const;
+        BEATSAVER_PLUSPLUS_EXPORT BeatSaver::API::Future<std::optional<std::vector<uint8_t>>> GetCoverImageAsync(std::stop_token stopToken = {}) const;
 
-        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::vector<uint8_t>> GetPreview() const;
-        BEATSAVER_PLUSPLUS_EXPORT void GetPreviewAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished) const;
-        BEATSAVER_PLUSPLUS_EXPORT std::future<std::optional<std::vector<uint8_t>>> GetPreviewAsync() const;
+        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::vector<uint8_t>> GetPreview(std::stop_token stopToken = {}) const;
+        BEATSAVER_PLUSPLUS_EXPORT void GetPreviewAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished, std::stop_token stopToken = {}) const;
+        BEATSAVER_PLUSPLUS_EXPORT BeatSaver::API::Future<std::optional<std::vector<uint8_t>>> GetPreviewAsync(std::stop_token stopToken = {}) const;
 );
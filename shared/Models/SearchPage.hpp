@@ -6,4 +6,14 @@
 SERDE_STRUCT(BeatSaver::Models, SearchPage,
     BEATSAVER_PLUSPLUS_GETTER_FIELD(std::vector<Beatmap>, Docs, "docs");
     BEATSAVER_PLUSPLUS_GETTER_FIELD_OPTIONAL(UserDetail, User, "user");
+
+    public:
+        /// @brief drops the maps the predicate is true for, it's called once for every map in order
+        void EraseDocs(std::function<bool(Beatmap const&)> const& predicate) {
+            std::vector<Beatmap> kept;
+            for (auto& doc : __Docs) {
+                if (!predicate(doc)) kept.emplace_back(std::move(doc));
+            }
+            __Docs = std::move(kept);
+        }
 );
@@ -2,6 +2,7 @@
 
 #include "../macros.hpp"
 #include "UserStats.hpp"
+#include <stop_token>
 
 SERDE_STRUCT(BeatSaver::Models, UserDetail,
     BEATSAVER_PLUSPLUS_GETTER_FIELD(int, Id, "id");
@@ -12,6 +13,6 @@ SERDE_STRUCT(BeatSaver::Models, UserDetail,
     BEATSAVER_PLUSPLUS_GETTER_FIELD_OPTIONAL(UserStats, Stats, "stats");
 
     public:
-        BEATSAVER_PLUSPLUS_EXPORT void GetAvatarImageAsync(std::function<void(std::optional<std::vector<uint8_t>>)>) const;
-        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::vector<uint8_t>> GetAvatarImage() const;
+        BEATSAVER_PLUSPLUS_EXPORT void GetAvatarImageAsync(std::function<void(std::optional<std::vector<uint8_t>>)>, std::stop_token stopToken = {}) const;
+        BEATSAVER_PLUSPLUS_EXPORT std::optional<std::vector<uint8_t>> GetAvatarImage(std::stop_token stopToken = {}) const;
 )
@@ -0,0 +1,414 @@
+#pragma once
+
+#include "./_config.h"
+#include "./BeatSaver.hpp"
+#include "./Future.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace BeatSaver::API {
+    /// @brief what a received page means for the ones after it
+    enum class PageStep {
+        /// @brief another page may follow this one
+        HasNext,
+        /// @brief this is the final page
+        Last,
+        /// @brief there was nothing on this page, the listing ended before it
+        Empty
+    };
+
+    /// @brief lazily walks the pages of a listing endpoint, keeping the next few pages requested in the background while the current one is used.
+    /// numbered sources request every page of the read-ahead at once, chained sources need the previous page to know what to ask for next
+    /// so they keep at most one request in flight, still ahead of the consumer.
+    /// a cursor is meant to be consumed from one thread, destroying it drops prefetches that haven't started yet
+    template<typename Response>
+    class PageCursor {
+        public:
+            /// @brief starts the request for a page
+            using RequestFunction = std::function<Future<Response>(int page, std::stop_token stopToken)>;
+            /// @brief looks at a received page, for chained sources this is also where the request for the next page is set up.
+            /// it may drop what the consumer shouldn't see from the page, like maps an earlier page handed out already
+            using StepFunction = std::function<PageStep(Response& response)>;
+
+            /// @brief cursor over an endpoint taking page numbers
+            /// @param request requests the given page
+            /// @param step tells when the listing ends
+            /// @param firstPage page number the cursor starts at
+            /// @param readAhead how many pages are kept requested ahead of the consumer, at least 1
+            static PageCursor Numbered(RequestFunction request, StepFunction step, int firstPage = 0, std::size_t readAhead = 2) {
+                return PageCursor(std::move(request), std::move(step), false, firstPage, readAhead);
+            }
+
+            /// @brief cursor over an endpoint where each request is built from the page before it, like the timestamp based ones
+            /// @param request requests the next page, the page number only counts how many came before it
+            /// @param step tells when the listing ends and moves whatever request captures along to the page after this one
+            /// @param readAhead how many received pages may wait for the consumer, at least 1
+            static PageCursor Chained(RequestFunction request, StepFunction step, std::size_t readAhead = 2) {
+                return PageCursor(std::move(request), std::move(step), true, 0, readAhead);
+            }
+
+            PageCursor(PageCursor&&) noexcept = default;
+            PageCursor& operator=(PageCursor&& other) noexcept {
+                if (this != &other) {
+                    Stop();
+                    state = std::move(other.state);
+                }
+                return *this;
+            }
+            PageCursor(PageCursor const&) = delete;
+            PageCursor& operator=(PageCursor const&) = delete;
+
+            ~PageCursor() { Stop(); }
+
+            /// @brief gets the next page, blocking only if its prefetch isn't done yet.
+            /// a failed response is handed out as is, after which the cursor ends
+            /// @param stopToken stops waiting for the page, the page stays next in line
+            /// @return the page, nullopt once the listing ended or when stopped while waiting
+            std::optional<Response> Next(std::stop_token stopToken = {}) {
+                Fill(state);
+
+                Future<Slot>* front = nullptr;
+                {
+                    std::unique_lock lock(state->mutex);
+                    if (state->pending.empty()) return std::nullopt;
+                    // only the consumer pops, and pushing to a deque leaves references alone
+                    front = &state->pending.front();
+                }
+                if (!front->wait(stopToken)) return std::nullopt;
+
+                Future<Slot> page;
+                {
+                    std::unique_lock lock(state->mutex);
+                    page = std::move(state->pending.front());
+                    state->pending.pop_front();
+                }
+
+                std::optional<Slot> slot;
+                try {
+                    slot.emplace(page.get());
+                } catch (...) {
+                    End();
+                    throw;
+                }
+
+                if (slot->step == PageStep::HasNext) Fill(state);
+                else End();
+
+                if (slot->step == PageStep::Empty) return std::nullopt;
+                return std::move(slot->response);
+            }
+
+            /// @brief whether Next may still return a page
+            bool HasNext() const {
+                std::unique_lock lock(state->mutex);
+                return !state->pending.empty() || state->more;
+            }
+
+            struct Iterator {
+                using iterator_category = std::input_iterator_tag;
+                using difference_type = std::ptrdiff_t;
+                using value_type = Response;
+
+                PageCursor* cursor = nullptr;
+                std::optional<Response> current = std::nullopt;
+
+                Response& operator*() { return current.value(); }
+                Response* operator->() { return &current.value(); }
+                Iterator& operator++() {
+                    current = cursor->Next();
+                    return *this;
+                }
+                void operator++(int) { ++*this; }
+                bool operator==(std::default_sentinel_t) const { return !current.has_value(); }
+            };
+
+            /// @brief range-for over the remaining pages, which fetches the first one
+            Iterator begin() { return Iterator{this, Next()}; }
+            std::default_sentinel_t end() { return std::default_sentinel; }
+        private:
+            struct Slot {
+                Response response;
+                PageStep step;
+            };
+
+            struct State {
+                RequestFunction request;
+                StepFunction step;
+                bool chained;
+                std::size_t readAhead;
+                std::stop_source stopSource;
+
+                std::mutex mutex;
+                std::deque<Future<Slot>> pending;
+                int nextPage;
+                bool more = true;
+                bool inFlight = false;
+            };
+
+            PageCursor(RequestFunction request, StepFunction step, bool chained, int firstPage, std::size_t readAhead) : state(std::make_shared<State>()) {
+                state->request = std::move(request);
+                state->step = std::move(step);
+                state->chained = chained;
+                state->readAhead = std::max<std::size_t>(readAhead, 1);
+                state->nextPage = firstPage;
+            }
+
+            /// @brief tops the read-ahead up, requests are started outside the lock since an already finished future continues right away
+            static void Fill(std::shared_ptr<State> const& state) {
+                std::vector<std::pair<int, Promise<Slot>>> started;
+                {
+                    std::unique_lock lock(state->mutex);
+                    while (state->more && !state->stopSource.stop_requested() && state->pending.size() < state->readAhead && !(state->chained && state->inFlight)) {
+                        Promise<Slot> promise;
+                        state->pending.emplace_back(promise.GetFuture());
+                        started.emplace_back(state->nextPage++, std::move(promise));
+                        state->inFlight = true;
+                    }
+                }
+
+                for (auto& [page, promise] : started) {
+                    // a request that throws breaks the promise, which the consumer gets to see
+                    (void)state->request(page, state->stopSource.get_token()).Then([state, promise = std::move(promise)](Response response) mutable {
+                        PageStep step;
+                        {
+                            std::unique_lock lock(state->mutex);
+                            step = state->step(response);
+                            if (step != PageStep::HasNext) state->more = false;
+                            state->inFlight = false;
+                        }
+                        promise.SetValue(Slot{std::move(response), step});
+                        if (step == PageStep::HasNext && state->chained) Fill(state);
+                    });
+                }
+            }
+
+            /// @brief nothing comes after the current page, pages requested past it are dropped
+            void End() {
+                std::deque<Future<Slot>> dropped;
+                {
+                    std::unique_lock lock(state->mutex);
+                    state->more = false;
+                    dropped.swap(state->pending);
+                }
+                state->stopSource.request_stop();
+            }
+
+            void Stop() {
+                if (state) state->stopSource.request_stop();
+            }
+
+            std::shared_ptr<State> state;
+    };
+
+    namespace Detail {
+        /// @brief page step for the search page and playlist listings, an empty page ends it and so does a short one when the page size is known
+        template<typename Response>
+        PageStep GetPageStep(Response const& response, std::size_t (*countItems)(typename decltype(Response::responseData)::value_type const&), std::optional<int> pageSize = std::nullopt) {
+            if (!response.IsSuccessful() || !response.responseData.has_value()) return PageStep::Last;
+            auto count = countItems(response.responseData.value());
+            if (count == 0) return PageStep::Empty;
+            if (pageSize.has_value() && count < (std::size_t)pageSize.value()) return PageStep::Last;
+            return PageStep::HasNext;
+        }
+
+        inline std::size_t CountSearchPageDocs(Models::SearchPage const& page) { return page.Docs.size(); }
+        inline std::size_t CountPlaylistSearchPageDocs(Models::PlaylistSearchPage const& page) { return page.Docs.size(); }
+        inline std::size_t CountPlaylistPageMaps(Models::PlaylistPage const& page) { return page.Maps.size(); }
+
+        /// @brief the date a map is ordered by in the latest listing
+        inline std::optional<std::string> GetLatestDate(Models::Beatmap const& map, std::optional<LatestSortOrder> sortOrder) {
+            switch (sortOrder.value_or(LatestSortOrder::FirstPublished)) {
+                using enum LatestSortOrder;
+                case FirstPublished: return map.Uploaded;
+                case Updated: return map.GetUpdatedAt();
+                case LastPublished: return map.GetLastPublishedAt();
+                case Created: return map.GetCreatedAt();
+                case Curated: return map.GetCuratedAt();
+            }
+            return std::nullopt;
+        }
+
+        /// @brief how far a page walked by time reaches back over where the page before it ended. before and after leave out maps at exactly that time,
+        /// this is just enough to take them in again, so the ones that didn't fit on the page before aren't skipped
+        inline constexpr std::chrono::microseconds PageBoundaryOverlap{1};
+
+        /// @brief parses a utc time the way beatsaver hands them out, like 2024-05-01T12:34:56.789Z
+        inline std::optional<std::chrono::system_clock::time_point> ParseTimestamp(std::string_view stamp) {
+            std::string str(stamp);
+            int year, month, day, hour, minute, second, read = 0;
+            if (std::sscanf(str.c_str(), "%d-%d-%dT%d:%d:%d%n", &year, &month, &day, &hour, &minute, &second, &read) != 6) return std::nullopt;
+
+            std::size_t i = read;
+            long long micros = 0;
+            if (i < str.size() && str[i] == '.') {
+                int digits = 0;
+                for (i++; i < str.size() && std::isdigit((unsigned char)str[i]); i++) {
+                    if (digits < 6) micros = micros * 10 + (str[i] - '0'), digits++;
+                }
+                for (; digits < 6; digits++) micros *= 10;
+            }
+            if (i >= str.size() || str[i] != 'Z') return std::nullopt;
+
+            std::chrono::year_month_day date{std::chrono::year(year), std::chrono::month(month), std::chrono::day(day)};
+            if (!date.ok()) return std::nullopt;
+            return std::chrono::sys_days(date) + std::chrono::hours(hour) + std::chrono::minutes(minute) + std::chrono::seconds(second) + std::chrono::microseconds(micros);
+        }
+
+        /// @brief formats a time the way ParseTimestamp reads it, to the microsecond
+        inline std::string FormatTimestamp(std::chrono::system_clock::time_point time) {
+            auto micros = std::chrono::time_point_cast<std::chrono::microseconds>(time);
+            auto day = std::chrono::floor<std::chrono::days>(micros);
+            std::chrono::year_month_day date(day);
+            std::chrono::hh_mm_ss clock(micros - day);
+            return fmt::format("{:04}-{:02}-{:02}T{:02}:{:02}:{:02}.{:06}Z", (int)date.year(), (unsigned)date.month(), (unsigned)date.day(), clock.hours().count(), clock.minutes().count(), clock.seconds().count(), clock.subseconds().count());
+        }
+    }
+
+    /// @brief cursor over search result pages
+    /// @param queryOptions misc query options
+    /// @param firstPage page to start at
+    /// @param readAhead how many pages are requested ahead of the one being used
+    inline PageCursor<BeatSaverResponse_t<&GetPageURLOptions>> GetPageCursor(SearchQueryOptions queryOptions = {}, int firstPage = 0, std::size_t readAhead = 2) {
+        using Response = BeatSaverResponse_t<&GetPageURLOptions>;
+        return PageCursor<Response>::Numbered([queryOptions](int page, std::stop_token stopToken) {
+            return GetPageAsync(page, queryOptions, nullptr, stopToken);
+        }, [](Response const& response) {
+            return Detail::GetPageStep(response, &Detail::CountSearchPageDocs);
+        }, firstPage, readAhead);
+    }
+
+    /// @brief cursor over the maps uploaded by a user
+    /// @param id user id
+    /// @param firstPage page to start at
+    /// @param readAhead how many pages are requested ahead of the one being used
+    inline PageCursor<BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>> GetBeatmapsByUserCursor(int id, int firstPage = 0, std::size_t readAhead = 2) {
+        using Response = BeatSaverResponse_t<&GetBeatmapsByUserURLOptions>;
+        return PageCursor<Response>::Numbered([id](int page, std::stop_token stopToken) {
+            return GetBeatmapsByUserAsync(id, page, nullptr, stopToken);
+        }, [](Response const& response) {
+            return Detail::GetPageStep(response, &Detail::CountSearchPageDocs);
+        }, firstPage, readAhead);
+    }
+
+    /// @brief cursor over the collaborations of a user, every page asks for the maps uploaded before the last one of the page it follows
+    /// @param id user id
+    /// @param queryOptions options for the first page
+    /// @param readAhead how many received pages may wait for the one being used
+    inline PageCursor<BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>> GetCollaborationsByUserCursor(int id, CollaborationQueryOptions queryOptions = {}, std::size_t readAhead = 2) {
+        using Response = BeatSaverResponse_t<&GetCollaborationsByUserURLOptions>;
+        // only touched by one request or step at a time, the cursor orders them
+        auto options = std::make_shared<CollaborationQueryOptions>(std::move(queryOptions));
+        return PageCursor<Response>::Chained([id, options](int, std::stop_token stopToken) {
+            return GetCollaborationsByUserAsync(id, *options, nullptr, stopToken);
+        }, [options](Response const& response) {
+            auto step = Detail::GetPageStep(response, &Detail::CountSearchPageDocs, options->pageSize);
+            if (step == PageStep::HasNext) options->before = response.responseData->GetDocs().back().Uploaded;
+            return step;
+        }, readAhead);
+    }
+
+    /// @brief cursor over the latest maps. pages go back in time from before, or forward from after when only that is given.
+    /// every page starts just over where the one before it ended, so maps sharing the time of a page's last map aren't skipped when they don't fit on it.
+    /// the maps at that time that were handed out already are dropped from the next page, a page may end up empty for it.
+    /// the only maps skipped are ties beyond a whole page, the api has no way to page through more maps of the exact same time than fit one page
+    /// @param queryOptions options for the first page
+    /// @param readAhead how many received pages may wait for the one being used
+    inline PageCursor<BeatSaverResponse_t<&GetLatestURLOptions>> GetLatestCursor(LatestQueryOptions queryOptions = {}, std::size_t readAhead = 2) {
+        using Response = BeatSaverResponse_t<&GetLatestURLOptions>;
+        // the time the furthest map handed out so far is at, and every map handed out at exactly that time
+        struct Boundary {
+            std::optional<std::chrono::system_clock::time_point> time = std::nullopt;
+            std::unordered_set<std::string> ids;
+        };
+        // only touched by one request or step at a time, the cursor orders them
+        auto options = std::make_shared<LatestQueryOptions>(std::move(queryOptions));
+        auto boundary = std::make_shared<Boundary>();
+        return PageCursor<Response>::Chained([options](int, std::stop_token stopToken) {
+            return GetLatestAsync(*options, nullptr, stopToken);
+        }, [options, boundary](Response& response) {
+            // whether the page ends the listing goes by what the api sent, not by what's left after dropping the overlap
+            auto step = Detail::GetPageStep(response, &Detail::CountSearchPageDocs, options->pageSize);
+            if (!response.IsSuccessful() || !response.responseData.has_value()) return step;
+
+            bool forward = options->after.has_value() && !options->before.has_value();
+            auto lastDate = step == PageStep::Empty ? std::nullopt : Detail::GetLatestDate(response.responseData->GetDocs().back(), options->sortOrder);
+            bool added = false;
+            response.responseData->EraseDocs([&](Models::Beatmap const& map) {
+                auto date = Detail::GetLatestDate(map, options->sortOrder);
+                auto time = date.has_value() ? Detail::ParseTimestamp(date.value()) : std::nullopt;
+                if (time.has_value() && boundary->time.has_value()) {
+                    if (forward ? time < boundary->time : time > boundary->time) return true;
+                    if (time == boundary->time && !boundary->ids.emplace(map.Id).second) return true;
+                }
+                if (time.has_value() && time != boundary->time) {
+                    boundary->time = time;
+                    boundary->ids = {map.Id};
+                }
+                // a map without a time doesn't move the walk along, it can't tell whether it's new either
+                added |= time.has_value();
+                return false;
+            });
+            if (step != PageStep::HasNext) return step;
+
+            timestamp next;
+            if (boundary->time.has_value() && added) {
+                next = Detail::FormatTimestamp(forward ? boundary->time.value() - Detail::PageBoundaryOverlap : boundary->time.value() + Detail::PageBoundaryOverlap);
+            } else if (boundary->time.has_value()) {
+                // a full page of maps handed out already, more maps share that time than fit a page so the walk has to move past them
+                next = Detail::FormatTimestamp(boundary->time.value());
+            } else if (lastDate.has_value()) {
+                // times that don't parse can only be continued from as they are
+                next = lastDate.value();
+            } else {
+                // without the date there's nothing to continue from
+                return PageStep::Last;
+            }
+
+            if (forward) options->after = next;
+            else options->before = next;
+            return step;
+        }, readAhead);
+    }
+
+    /// @brief cursor over playlist search result pages
+    /// @param queryOptions misc query options
+    /// @param firstPage page to start at
+    /// @param readAhead how many pages are requested ahead of the one being used
+    inline PageCursor<BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>> GetSearchPlaylistsCursor(SearchPlaylistsQueryOptions queryOptions = {}, int firstPage = 0, std::size_t readAhead = 2) {
+        using Response = BeatSaverResponse_t<&GetSearchPlaylistsURLOptions>;
+        return PageCursor<Response>::Numbered([queryOptions](int page, std::stop_token stopToken) {
+            return GetSearchPlaylistsAsync(page, queryOptions, nullptr, stopToken);
+        }, [](Response const& response) {
+            return Detail::GetPageStep(response, &Detail::CountPlaylistSearchPageDocs);
+        }, firstPage, readAhead);
+    }
+
+    /// @brief cursor over the maps of a playlist
+    /// @param playlistID the playlist to walk
+    /// @param firstPage page to start at
+    /// @param readAhead how many pages are requested ahead of the one being used
+    inline PageCursor<BeatSaverResponse_t<&GetPlaylistURLOptions>> GetPlaylistCursor(int playlistID, int firstPage = 0, std::size_t readAhead = 2) {
+        using Response = BeatSaverResponse_t<&GetPlaylistURLOptions>;
+        return PageCursor<Response>::Numbered([playlistID](int page, std::stop_token stopToken) {
+            return GetPlaylistAsync(playlistID, page, nullptr, stopToken);
+        }, [](Response const& response) {
+            return Detail::GetPageStep(response, &Detail::CountPlaylistPageMaps);
+        }, firstPage, readAhead);
+    }
+}
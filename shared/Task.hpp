@@ -0,0 +1,156 @@
+#pragma once
+
+#include "./_config.h"
+#include "./Executor.hpp"
+#include "./Future.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace BeatSaver::API {
+    template<typename T = void>
+    class Task;
+
+    namespace Detail {
+        template<typename T>
+        struct TaskPromiseBase {
+            /// @brief what gets resumed once the task finishes, nothing if it wasn't awaited
+            std::coroutine_handle<> continuation = std::noop_coroutine();
+            std::exception_ptr exception = nullptr;
+
+            // tasks are lazy, they start once they are awaited
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                template<typename P>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept { return handle.promise().continuation; }
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept { return {}; }
+            void unhandled_exception() { exception = std::current_exception(); }
+        };
+
+        template<typename T>
+        struct TaskPromise : public TaskPromiseBase<T> {
+            std::optional<T> value = std::nullopt;
+
+            Task<T> get_return_object();
+            void return_value(T result) { value.emplace(std::move(result)); }
+            T Result() {
+                if (this->exception) std::rethrow_exception(this->exception);
+                return std::move(value.value());
+            }
+        };
+
+        template<>
+        struct TaskPromise<void> : public TaskPromiseBase<void> {
+            Task<void> get_return_object();
+            void return_void() {}
+            void Result() {
+                if (this->exception) std::rethrow_exception(this->exception);
+            }
+        };
+
+        /// @brief fire and forget coroutine, used to start a task from outside of any coroutine
+        struct DetachedTask {
+            struct promise_type {
+                DetachedTask get_return_object() { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() {}
+                // the started task reports its own failure through the callback or future it was started with
+                void unhandled_exception() {}
+            };
+        };
+    }
+
+    /// @brief a lazily started coroutine producing a T. co_await it from another coroutine, or start it with Spawn or ToFuture.
+    /// awaiting a task doesn't block a thread, the awaiting coroutine is resumed on whatever thread the task finished on
+    template<typename T>
+    class [[nodiscard]] Task {
+        public:
+            using promise_type = Detail::TaskPromise<T>;
+
+            explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+            Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+            Task& operator=(Task&& other) noexcept {
+                if (this != &other) {
+                    if (handle) handle.destroy();
+                    handle = std::exchange(other.handle, nullptr);
+                }
+                return *this;
+            }
+            Task(Task const&) = delete;
+            Task& operator=(Task const&) = delete;
+            ~Task() { if (handle) handle.destroy(); }
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            T await_resume() { return handle.promise().Result(); }
+        private:
+            std::coroutine_handle<promise_type> handle;
+    };
+
+    template<typename T>
+    Task<T> Detail::TaskPromise<T>::get_return_object() {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> Detail::TaskPromise<void>::get_return_object() {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+
+    /// @brief co_await this to continue the coroutine on the executor, so blocking work after it doesn't run on the awaiting thread
+    struct SwitchToExecutor {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { Executor::GetInstance().Post([handle]() { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+
+    /// @brief starts a task without waiting for it
+    /// @param onFinished called with the result once the task is done, not called if the task threw
+    template<typename T>
+    void Spawn(Task<T> task, std::function<void(T)> onFinished = nullptr) {
+        [](Task<T> task, std::function<void(T)> onFinished) -> Detail::DetachedTask {
+            auto result = co_await task;
+            if (onFinished) onFinished(std::move(result));
+        }(std::move(task), std::move(onFinished));
+    }
+
+    /// @brief starts a task without waiting for it
+    /// @param onFinished called once the task is done, not called if the task threw
+    inline void Spawn(Task<void> task, std::function<void()> onFinished = nullptr) {
+        [](Task<void> task, std::function<void()> onFinished) -> Detail::DetachedTask {
+            co_await task;
+            if (onFinished) onFinished();
+        }(std::move(task), std::move(onFinished));
+    }
+
+    /// @brief starts a task and gets a future for its result, for code that isn't a coroutine
+    template<typename T>
+    Future<T> ToFuture(Task<T> task) {
+        Promise<T> promise;
+        auto future = promise.GetFuture();
+        [](Task<T> task, Promise<T> promise) -> Detail::DetachedTask {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await task;
+                    promise.SetValue();
+                } else {
+                    promise.SetValue(co_await task);
+                }
+            } catch (...) {
+                promise.SetException(std::current_exception());
+            }
+        }(std::move(task), std::move(promise));
+        return future;
+    }
+}
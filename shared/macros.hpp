@@ -4,9 +4,11 @@
 #include "./Exceptions.hpp"
 #include "./Models/Serde.hpp"
 
-// declares a simple generic response that parses json into the set `type_`
+// declares a simple generic response that parses json into the set `type_`, stale is set when it came from a local cache because beatsaver couldn't be reached
 #define BEATSAVER_PLUSPLUS_DECLARE_SIMPLE_RESPONSE_T(namespace_, type_)                            \
 struct type_##Response : public WebUtils::GenericResponse<namespace_::type_> {  \
+    bool stale = false;                                                         \
+                                                                                \
     bool AcceptData(std::span<uint8_t const> data) override {                   \
         rapidjson::Document doc;                                                \
         doc.Parse((char*)data.data(), data.size());                             \
@@ -0,0 +1,192 @@
+#include "BeatSaver.hpp"
+#include "LruCache.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace BeatSaver::API {
+    static std::atomic<std::uintmax_t> _assetCacheDiskBudget = 0;
+
+    static std::atomic<uint64_t> _memoryHits = 0;
+    static std::atomic<uint64_t> _diskHits = 0;
+    static std::atomic<uint64_t> _misses = 0;
+
+    static Utils::LruCache<std::string, std::shared_ptr<RawResponse const>>& GetMemoryTier() {
+        // never destroyed, requests may still be running while statics get torn down
+        static auto cache = new Utils::LruCache<std::string, std::shared_ptr<RawResponse const>>(16 * 1024 * 1024);
+        return *cache;
+    }
+
+    // the disk tier is shared by every request thread, eviction and adding have to agree on what's in it
+    static std::mutex diskMutex;
+    // combined size of the stored assets, worked out by scanning the dir on first use
+    static std::optional<std::uintmax_t> diskSize;
+
+    void SetAssetCacheMemoryBudget(std::size_t budget) {
+        GetMemoryTier().SetBudget(budget);
+    }
+
+    std::size_t GetAssetCacheMemoryBudget() {
+        return GetMemoryTier().GetBudget();
+    }
+
+    void SetAssetCacheDiskBudget(std::uintmax_t budget) {
+        _assetCacheDiskBudget = budget;
+    }
+
+    std::uintmax_t GetAssetCacheDiskBudget() {
+        return _assetCacheDiskBudget;
+    }
+
+    AssetCacheStats GetAssetCacheStats() {
+        return AssetCacheStats{
+            .memoryHits = _memoryHits,
+            .diskHits = _diskHits,
+            .misses = _misses,
+            .memoryBytes = GetMemoryTier().GetSize(),
+        };
+    }
+
+    void ResetAssetCacheStats() {
+        _memoryHits = 0;
+        _diskHits = 0;
+        _misses = 0;
+    }
+
+    static std::filesystem::path GetAssetsPath() {
+        return GetDataPath() / "assets";
+    }
+
+    /// @brief file the asset is stored in, the hash plus the extension of the url so a cover and preview of one map don't collide.
+    /// nullopt if the hash isn't a sha1 hex string, so it can't be used to escape the assets dir
+    static std::optional<std::filesystem::path> GetAssetPath(std::string_view hash, std::string_view url) {
+        if (hash.size() != 40) return std::nullopt;
+
+        std::string name(hash);
+        for (auto& c : name) {
+            if (!std::isxdigit((unsigned char)c)) return std::nullopt;
+            c = std::tolower((unsigned char)c);
+        }
+
+        auto query = url.find_first_of("?#");
+        if (query != std::string_view::npos) url = url.substr(0, query);
+        auto slash = url.rfind('/');
+        auto dot = url.rfind('.');
+        if (dot != std::string_view::npos && (slash == std::string_view::npos || dot > slash)) {
+            auto extension = url.substr(dot);
+            if (extension.size() <= 8 && std::ranges::all_of(extension.substr(1), [](char c) { return std::isalnum((unsigned char)c); })) name += extension;
+        }
+        return GetAssetsPath() / name;
+    }
+
+    /// @brief deletes the least recently used assets until the disk tier fits the budget again, expects diskMutex to be held
+    static void EvictAssets(std::uintmax_t budget) {
+        struct StoredAsset {
+            std::filesystem::path path;
+            std::uintmax_t size;
+            std::filesystem::file_time_type lastUsed;
+        };
+
+        std::error_code ec;
+        std::vector<StoredAsset> stored;
+        std::uintmax_t size = 0;
+        for (auto const& entry : std::filesystem::directory_iterator(GetAssetsPath(), ec)) {
+            if (!entry.is_regular_file(ec) || entry.path().extension() == ".tmp") continue;
+            auto entrySize = entry.file_size(ec);
+            if (ec) continue;
+            stored.push_back({entry.path(), entrySize, entry.last_write_time(ec)});
+            size += entrySize;
+        }
+
+        if (size > budget) {
+            std::ranges::sort(stored, {}, &StoredAsset::lastUsed);
+            for (auto const& asset : stored) {
+                if (size <= budget) break;
+                if (std::filesystem::remove(asset.path, ec)) size -= asset.size;
+            }
+        }
+        diskSize = size;
+    }
+
+    static std::optional<std::vector<uint8_t>> FindOnDisk(std::filesystem::path const& assetPath) {
+        std::unique_lock lock(diskMutex);
+        std::ifstream file(assetPath, std::ios::in | std::ios::binary);
+        if (!file.is_open()) return std::nullopt;
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+
+        // the modification time doubles as the last use for eviction
+        std::error_code ec;
+        std::filesystem::last_write_time(assetPath, std::filesystem::file_time_type::clock::now(), ec);
+        return data;
+    }
+
+    static void StoreOnDisk(std::filesystem::path const& assetPath, std::span<uint8_t const> data, std::uintmax_t budget) {
+        std::unique_lock lock(diskMutex);
+        if (!diskSize.has_value()) EvictAssets(budget);
+
+        // written next to the final name first, so a half written asset never gets found
+        auto tempPath = assetPath;
+        tempPath += ".tmp";
+
+        std::error_code ec;
+        std::filesystem::create_directories(assetPath.parent_path(), ec);
+        auto replacedSize = std::filesystem::file_size(assetPath, ec);
+        if (ec) replacedSize = 0;
+        {
+            std::ofstream of(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            of.write((char const*)data.data(), data.size());
+            if (!of.good()) {
+                WARNING("Could not write {} to the asset cache", assetPath.filename().string());
+                of.close();
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+        }
+        std::filesystem::rename(tempPath, assetPath, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            return;
+        }
+
+        diskSize = diskSize.value() - std::min(diskSize.value(), replacedSize) + data.size();
+        if (diskSize.value() > budget) EvictAssets(budget);
+    }
+
+    std::shared_ptr<RawResponse const> FetchAsset(WebUtils::URLOptions const& urlOptions, std::string_view hash, progress_function progressReport, std::stop_token stopToken) {
+        auto& memoryTier = GetMemoryTier();
+        if (auto cached = memoryTier.Find(urlOptions.url)) {
+            _memoryHits++;
+            if (progressReport) progressReport(1.0f);
+            return cached.value();
+        }
+
+        auto diskBudget = GetAssetCacheDiskBudget();
+        auto assetPath = diskBudget > 0 ? GetAssetPath(hash, urlOptions.url) : std::nullopt;
+        if (assetPath.has_value()) {
+            if (auto data = FindOnDisk(assetPath.value())) {
+                _diskHits++;
+                auto size = data->size();
+                auto response = std::make_shared<RawResponse const>(RawResponse{200, 0, std::move(data)});
+                memoryTier.Insert(urlOptions.url, response, size);
+                if (progressReport) progressReport(1.0f);
+                return response;
+            }
+        }
+
+        auto response = FetchRaw(urlOptions, std::move(progressReport), stopToken);
+        if (response->curlStatus == CancelledCurlStatus) return response;
+        _misses++;
+
+        if (response->curlStatus == 0 && response->httpCode == 200 && response->data.has_value()) {
+            memoryTier.Insert(urlOptions.url, response, response->data->size());
+            if (assetPath.has_value() && response->data->size() <= diskBudget) StoreOnDisk(assetPath.value(), response->data.value(), diskBudget);
+        }
+        return response;
+    }
+}
@@ -1,12 +1,24 @@
 #include "BeatSaver.hpp"
+#include "DownloadManager.hpp"
+#include "HttpCache.hpp"
+#include "InstalledManifest.hpp"
 #include "Utils.hpp"
+#include "ZipStore.hpp"
+#include "SingleFlight.hpp"
 #include "logging.hpp"
 
-#include "web-utils/shared/RatelimitedDispatcher.hpp"
 #include "Exceptions.hpp"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cmath>
 #include <ctime>
+#include <fstream>
 #include <future>
+#include <mutex>
+#include <random>
+#include <thread>
 #include <variant>
 
 namespace BeatSaver::API {
@@ -15,6 +27,232 @@ namespace BeatSaver::API {
         return downloader;
     }
 
+    static std::mutex _retryPolicyMutex;
+    static RetryPolicy _retryPolicy;
+
+    void SetRetryPolicy(RetryPolicy policy) {
+        std::unique_lock lock(_retryPolicyMutex);
+        _retryPolicy = std::move(policy);
+    }
+
+    RetryPolicy GetRetryPolicy() {
+        std::unique_lock lock(_retryPolicyMutex);
+        return _retryPolicy;
+    }
+
+    bool IsRetryableFailure(long httpCode, int curlStatus) {
+        if (curlStatus != 0) {
+            // unsupported protocol, malformed url and features curl wasn't built with fail the same way every time
+            return curlStatus != 1 && curlStatus != 3 && curlStatus != 4;
+        }
+
+        if (httpCode == 408 || httpCode == 425 || httpCode == 429) return true;
+        return httpCode >= 500 && httpCode != 501;
+    }
+
+    std::chrono::milliseconds RetryPolicy::GetDelay(int retry, long httpCode) const {
+        thread_local std::mt19937 random(std::random_device{}());
+
+        // full jitter: anywhere between nothing and the exponential delay
+        auto exponent = std::clamp(retry - 1, 0, 30);
+        auto cap = std::min<int64_t>(maxDelay.count(), baseDelay.count() * (int64_t(1) << exponent));
+        auto delay = std::chrono::milliseconds(std::uniform_int_distribution<int64_t>(0, std::max<int64_t>(cap, 0))(random));
+
+        if (httpCode == 429 || httpCode == 503) delay = std::max(delay, rateLimitedDelay);
+        return delay;
+    }
+
+    void RetryRequest(std::function<std::pair<long, int>()> const& request, std::stop_token stopToken) {
+        auto policy = GetRetryPolicy();
+        auto start = std::chrono::steady_clock::now();
+
+        for (int attempt = 1;; attempt++) {
+            auto [httpCode, curlStatus] = request();
+
+            bool failed = curlStatus != 0 || httpCode < 200 || httpCode >= 300;
+            if (!failed || attempt >= policy.maxAttempts || stopToken.stop_requested()) return;
+            // retrying can't help while beatsaver is unreachable, it would only stall the caller for the whole retry budget
+            if (IsOffline()) return;
+            if (!(policy.isRetryable ? policy.isRetryable(httpCode, curlStatus) : IsRetryableFailure(httpCode, curlStatus))) return;
+
+            auto delay = policy.GetDelay(attempt, httpCode);
+            if (policy.timeBudget.count() > 0 && std::chrono::steady_clock::now() + delay - start > policy.timeBudget) return;
+
+            DEBUG("Attempt {} failed with http {} curl {}, retrying in {}ms", attempt, httpCode, curlStatus, delay.count());
+            // waits for the delay, unless a stop is requested before it's over
+            std::mutex delayMutex;
+            std::condition_variable_any delayOver;
+            std::unique_lock lock(delayMutex);
+            if (delayOver.wait_for(lock, stopToken, delay, []() { return false; })) return;
+            if (stopToken.stop_requested()) return;
+        }
+    }
+
+    /// @brief a single attempt at a get request, without retries or sharing. the caller takes a rate limiter slot first
+    static std::shared_ptr<RawResponse const> FetchRawOnce(WebUtils::URLOptions const& urlOptions, progress_function const& progressReport) {
+        auto response = GetBeatsaverDownloader().Get<WebUtils::DataResponse>(urlOptions, progressReport);
+        ReportRequestResult(urlOptions.url, response.HttpCode, response.CurlStatus);
+        return std::make_shared<RawResponse const>(RawResponse{response.HttpCode, response.CurlStatus, std::move(response.responseData)});
+    }
+
+    static std::shared_ptr<RawResponse const> CancelledResponse() {
+        static auto const cancelled = std::make_shared<RawResponse const>(RawResponse{0, CancelledCurlStatus, std::nullopt});
+        return cancelled;
+    }
+
+    static std::shared_ptr<RawResponse const> OfflineResponse() {
+        static auto const offline = std::make_shared<RawResponse const>(RawResponse{0, OfflineCurlStatus, std::nullopt});
+        return offline;
+    }
+
+    /// @brief the shared and retried part of FetchRaw, runs on the calling thread
+    static std::shared_ptr<RawResponse const> FetchShared(WebUtils::URLOptions const& urlOptions, progress_function progressReport, std::stop_token stopToken) {
+        static Utils::SingleFlight<std::shared_ptr<RawResponse const>> inFlightRequests;
+        auto requestKey = Utils::GetRequestKey(urlOptions);
+        auto response = inFlightRequests.Run(requestKey, std::move(progressReport), stopToken, [&urlOptions, &requestKey](progress_function progress, std::stop_token sharedToken) {
+            // partial bodies aren't worth keeping
+            bool useHttpCache = GetHttpCacheBudget() > 0 && !urlOptions.headers.contains("Range");
+            auto cached = useHttpCache ? HttpCache::Find(requestKey) : std::nullopt;
+            auto requestOptions = urlOptions;
+            auto ifModifiedSince = cached.has_value() ? HttpCache::GetIfModifiedSince(cached.value()) : std::nullopt;
+            if (ifModifiedSince.has_value()) requestOptions.headers["If-Modified-Since"] = std::move(ifModifiedSince.value());
+
+            std::shared_ptr<RawResponse const> response;
+            if (Detail::ShouldShortCircuit()) {
+                response = OfflineResponse();
+            } else {
+                RetryRequest([&]() {
+                    if (!AcquireRequestSlot(requestOptions.url, sharedToken)) return std::pair<long, int>(0, CancelledCurlStatus);
+                    response = FetchRawOnce(requestOptions, progress);
+                    return std::pair<long, int>(response->httpCode, response->curlStatus);
+                }, sharedToken);
+            }
+            if (!response) return CancelledResponse();
+
+            if (cached.has_value() && GetOfflineMode() != OfflineMode::Disabled && Detail::IsConnectivityFailure(response->httpCode, response->curlStatus)) {
+                if (progress) progress(1.0f);
+                return std::make_shared<RawResponse const>(RawResponse{200, 0, std::move(cached->data), true});
+            }
+
+            if (response->curlStatus == 0 && response->httpCode == 304 && cached.has_value()) {
+                HttpCache::Touch(requestKey);
+                if (progress) progress(1.0f);
+                return std::make_shared<RawResponse const>(RawResponse{200, 0, std::move(cached->data)});
+            }
+            if (useHttpCache && response->curlStatus == 0 && response->httpCode == 200 && response->data.has_value()) {
+                HttpCache::Store(requestKey, response->data.value());
+            }
+            return response;
+        });
+        return response.value_or(CancelledResponse());
+    }
+
+    std::shared_ptr<RawResponse const> FetchRaw(WebUtils::URLOptions const& urlOptions, progress_function progressReport, std::stop_token stopToken) {
+        if (stopToken.stop_requested()) return CancelledResponse();
+
+        if (progressReport && stopToken.stop_possible()) {
+            progressReport = [progressReport = std::move(progressReport), stopToken](float progress) {
+                if (!stopToken.stop_requested()) progressReport(progress);
+            };
+        }
+
+        // a transfer can't be aborted once curl runs it, so a caller that may stop waits for it on the executor instead,
+        // that way it can walk away while the transfer finishes in the background. executor threads can't wait on themselves
+        if (!stopToken.stop_possible() || Executor::IsExecutorThread()) {
+            return FetchShared(urlOptions, std::move(progressReport), stopToken);
+        }
+
+        struct Pending {
+            std::mutex mutex;
+            std::condition_variable_any finished;
+            std::shared_ptr<RawResponse const> response;
+        };
+        auto pending = std::make_shared<Pending>();
+        Executor::GetInstance().Post([pending, urlOptions, progressReport = std::move(progressReport), stopToken]() {
+            auto response = FetchShared(urlOptions, progressReport, stopToken);
+            std::unique_lock lock(pending->mutex);
+            pending->response = std::move(response);
+            pending->finished.notify_all();
+        });
+
+        std::unique_lock lock(pending->mutex);
+        if (!pending->finished.wait(lock, stopToken, [&pending]() { return pending->response != nullptr; })) return CancelledResponse();
+        return pending->response;
+    }
+
+    static std::atomic_int _maxBatchConcurrency = 4;
+
+    void SetMaxBatchConcurrency(int maxConcurrency) {
+        _maxBatchConcurrency = std::max(maxConcurrency, 1);
+    }
+
+    int GetMaxBatchConcurrency() {
+        return _maxBatchConcurrency;
+    }
+
+    std::vector<std::shared_ptr<RawResponse const>> FetchChunks(std::vector<WebUtils::URLOptions> const& urlOptions, progress_function progressReport, std::stop_token stopToken) {
+        if (urlOptions.empty()) return {};
+
+        // helpers can start after the caller already returned, so everything they touch lives in here
+        struct Batch {
+            std::vector<WebUtils::URLOptions> urlOptions;
+            std::vector<std::shared_ptr<RawResponse const>> responses;
+            std::vector<float> progress;
+            progress_function progressReport;
+            std::stop_token stopToken;
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::size_t next = 0;
+            std::size_t done = 0;
+        };
+        auto batch = std::make_shared<Batch>();
+        batch->urlOptions = urlOptions;
+        batch->responses.resize(urlOptions.size());
+        batch->progress.resize(urlOptions.size());
+        batch->progressReport = std::move(progressReport);
+        batch->stopToken = stopToken;
+
+        // takes chunks until none are left, the caller runs it too so it only ever waits on chunks somebody is fetching
+        auto fetchChunks = [batch]() {
+            while (true) {
+                std::size_t index;
+                {
+                    std::unique_lock lock(batch->mutex);
+                    if (batch->next == batch->urlOptions.size()) return;
+                    index = batch->next++;
+                }
+
+                progress_function chunkProgress = nullptr;
+                if (batch->progressReport) {
+                    chunkProgress = [batch, index](float progress) {
+                        float total = 0;
+                        {
+                            std::unique_lock lock(batch->mutex);
+                            batch->progress[index] = progress;
+                            for (auto p : batch->progress) total += p;
+                        }
+                        batch->progressReport(total / batch->progress.size());
+                    };
+                }
+
+                auto response = FetchRaw(batch->urlOptions[index], chunkProgress, batch->stopToken);
+
+                std::unique_lock lock(batch->mutex);
+                batch->responses[index] = std::move(response);
+                batch->done++;
+                batch->finished.notify_all();
+            }
+        };
+
+        auto helpers = std::min<std::size_t>(GetMaxBatchConcurrency(), urlOptions.size()) - 1;
+        for (std::size_t i = 0; i < helpers; i++) Executor::GetInstance().Post(fetchChunks);
+        fetchChunks();
+
+        std::unique_lock lock(batch->mutex);
+        batch->finished.wait(lock, [&batch]() { return batch->done == batch->urlOptions.size(); });
+        return batch->responses;
+    }
+
     static std::filesystem::path _defaultOutputRoothPath = "/sdcard/ModData/com.beatgames.beatsaber/Mods/SongCore/CustomLevels";
 
     void Init(std::filesystem::path defaultOutputRootPath) {
@@ -25,16 +263,264 @@ namespace BeatSaver::API {
         return _defaultOutputRoothPath;
     }
 
-    std::future<bool> DownloadSongZipAsync(WebUtils::URLOptions urlOptions, std::filesystem::path outputPath, std::function<void(float)> progressReport) {
-        return std::async(std::launch::any, &DownloadSongZip, std::forward<WebUtils::URLOptions>(urlOptions), std::forward<std::filesystem::path>(outputPath), std::forward<std::function<void(float)>>(progressReport));
+    static std::filesystem::path _dataPath = "/sdcard/ModData/com.beatgames.beatsaber/Mods/BeatSaverPlusPlus";
+
+    void SetDataPath(std::filesystem::path dataPath) {
+        _dataPath = dataPath;
+    }
+
+    std::filesystem::path GetDataPath() {
+        return _dataPath;
+    }
+
+    static std::atomic<std::size_t> _downloadChunkSize = 8 * 1024 * 1024;
+
+    void SetDownloadChunkSize(std::size_t chunkSize) {
+        _downloadChunkSize = chunkSize;
+    }
+
+    std::size_t GetDownloadChunkSize() {
+        return _downloadChunkSize;
+    }
+
+    static std::atomic<std::uintmax_t> _zipStoreBudget = 0;
+
+    void SetZipStoreBudget(std::uintmax_t budget) {
+        _zipStoreBudget = budget;
+    }
+
+    std::uintmax_t GetZipStoreBudget() {
+        return _zipStoreBudget;
+    }
+
+    static std::atomic<std::uintmax_t> _httpCacheBudget = 0;
+
+    void SetHttpCacheBudget(std::uintmax_t budget) {
+        _httpCacheBudget = budget;
+    }
+
+    std::uintmax_t GetHttpCacheBudget() {
+        return _httpCacheBudget;
+    }
+
+    static std::atomic_bool _skipInstalledMaps = false;
+
+    void SetSkipInstalledMaps(bool skipInstalled) {
+        _skipInstalledMaps = skipInstalled;
+    }
+
+    bool GetSkipInstalledMaps() {
+        return _skipInstalledMaps;
+    }
+
+    std::optional<std::filesystem::path> GetInstalledMapPath(std::string_view hash) {
+        auto entry = InstalledManifest::Find(hash);
+        if (!entry.has_value()) return std::nullopt;
+        return entry->folder;
     }
 
-    bool DownloadSongZip(WebUtils::URLOptions urlOptions, std::filesystem::path outputPath, std::function<void(float)> progressReport) {
-        auto data = GetBeatsaverDownloader().Get<WebUtils::DataResponse>(urlOptions, progressReport);
+    // the total size is unknown until the last chunk arrives, so every chunk fills half of the remaining bar
+    static float ChunkedProgress(int chunkIndex, float chunkProgress) {
+        return 1.0f - std::pow(0.5f, chunkIndex) * (1.0f - chunkProgress * 0.5f);
+    }
+
+    // how many bytes before the resume offset are requested again, to check the remote file is still the one the part file came from
+    static constexpr std::size_t ResumeOverlapSize = 4 * 1024;
+    static std::filesystem::path GetResumeInfoPath(std::filesystem::path const& filePath) {
+        auto resumeInfoPath = filePath;
+        resumeInfoPath += ".url";
+        return resumeInfoPath;
+    }
+
+    /// @brief figures out where a previous attempt to download url into filePath stopped, 0 if there is nothing to resume
+    static std::size_t GetResumeOffset(std::filesystem::path const& filePath, std::string const& url) {
+        std::ifstream resumeInfo(GetResumeInfoPath(filePath));
+        std::string previousUrl;
+        if (!resumeInfo.is_open() || !std::getline(resumeInfo, previousUrl) || previousUrl != url) return 0;
+
+        std::error_code ec;
+        auto size = std::filesystem::file_size(filePath, ec);
+        return ec ? 0 : size;
+    }
+
+    static bool MatchesFileTail(std::filesystem::path const& filePath, std::size_t fileSize, std::span<uint8_t const> data) {
+        std::ifstream file(filePath, std::ios::in | std::ios::binary);
+        if (!file.is_open()) return false;
+
+        std::vector<uint8_t> tail(data.size());
+        file.seekg(fileSize - data.size());
+        file.read((char*)tail.data(), tail.size());
+        return file.good() && std::equal(tail.begin(), tail.end(), data.begin());
+    }
+
+    bool DownloadToFile(WebUtils::URLOptions urlOptions, std::filesystem::path filePath, std::function<void(float)> progressReport, std::stop_token stopToken) {
+        std::error_code ec;
+        std::filesystem::create_directories(filePath.parent_path(), ec);
+
+        auto chunkSize = GetDownloadChunkSize();
+        // without ranges there is no way to continue a partial file
+        std::size_t offset = chunkSize > 0 ? GetResumeOffset(filePath, urlOptions.url) : 0;
+        if (offset > 0) {
+            INFO("Resuming download of {} at {} bytes", urlOptions.url, offset);
+        } else {
+            std::ofstream resumeInfo(GetResumeInfoPath(filePath), std::ios::out | std::ios::trunc);
+            resumeInfo << urlOptions.url << '\n';
+        }
+
+        std::ofstream of(filePath, std::ios::out | std::ios::binary | (offset > 0 ? std::ios::app : std::ios::trunc));
+        if (!of.is_open()) {
+            ERROR("Could not open {} for writing", filePath.string());
+            return false;
+        }
+
+        auto restart = [&]() {
+            of.close();
+            of.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+            offset = 0;
+        };
+
+        for (int chunkIndex = 0;;) {
+            if (stopToken.stop_requested()) return false;
+
+            // the first chunk of a resumed download also asks for the end of what's already on disk
+            auto overlap = chunkIndex == 0 ? std::min(offset, ResumeOverlapSize) : 0;
+            auto chunkOptions = urlOptions;
+            if (chunkSize > 0) chunkOptions.headers["Range"] = fmt::format("bytes={}-{}", offset - overlap, offset + chunkSize - 1);
+
+            // every attempt is reported on its own, so the download manager sees the 429s that got retried as well
+            std::shared_ptr<RawResponse const> response;
+            RetryRequest([&]() {
+                if (Detail::ShouldShortCircuit()) {
+                    response = OfflineResponse();
+                    return std::pair<long, int>(0, OfflineCurlStatus);
+                }
+                if (!AcquireRequestSlot(chunkOptions.url, stopToken)) return std::pair<long, int>(0, CancelledCurlStatus);
+
+                // the first progress report is the closest thing to a time to first byte webutils gives us
+                auto requestStart = std::chrono::steady_clock::now();
+                std::optional<std::chrono::steady_clock::time_point> firstByte = std::nullopt;
+                response = FetchRawOnce(chunkOptions, [&progressReport, &firstByte, chunkIndex](float p){
+                    if (!firstByte.has_value()) firstByte = std::chrono::steady_clock::now();
+                    if (progressReport) progressReport(ChunkedProgress(chunkIndex, p));
+                });
+
+                auto requestEnd = std::chrono::steady_clock::now();
+                DownloadManager::GetInstance().ReportTransfer(
+                    response->data.has_value() ? response->data->size() : 0,
+                    firstByte.value_or(requestEnd) - requestStart,
+                    requestEnd - requestStart,
+                    response->httpCode
+                );
+                return std::pair<long, int>(response->httpCode, response->curlStatus);
+            }, stopToken);
+            // stopped while waiting for the rate limiter
+            if (!response) return false;
+
+            auto http = response->httpCode;
+            if (response->curlStatus != 0 || (http != 200 && http != 206 && http != 416)) {
+                WARNING("Giving up on {} at {} bytes, http {} curl {}, keeping the partial file to resume later", urlOptions.url, offset, http, response->curlStatus);
+                return false;
+            }
+
+            if (http == 416 && offset > 0) {
+                // the remote file is shorter than the part file, so it is not the same file anymore
+                if (overlap > 0) {
+                    WARNING("{} changed since it was partially downloaded, starting over", urlOptions.url);
+                    restart();
+                    continue;
+                }
+                // range starts at the end of the file, so the previous chunk happened to be exactly the remainder
+                break;
+            }
+            if (http != 200 && http != 206) return false;
+
+            std::span<uint8_t const> data;
+            if (response->data.has_value()) data = response->data.value();
+
+            // a 200 means the server ignored the range and sent the entire file, so start over with that
+            if (http == 200) {
+                if (offset > 0) restart();
+                of.write((char const*)data.data(), data.size());
+                if (!of.good()) return false;
+                break;
+            }
+
+            if (overlap > 0) {
+                if (data.size() < overlap || !MatchesFileTail(filePath, offset, data.first(overlap))) {
+                    WARNING("{} changed since it was partially downloaded, starting over", urlOptions.url);
+                    restart();
+                    continue;
+                }
+                data = data.subspan(overlap);
+            }
+
+            if (!data.empty()) of.write((char const*)data.data(), data.size());
+            if (!of.good()) return false;
+
+            offset += data.size();
+            chunkIndex++;
+            if (data.size() < chunkSize) break;
+        }
+
+        of.close();
+        std::filesystem::remove(GetResumeInfoPath(filePath), ec);
+        if (progressReport) progressReport(1.0f);
+        return true;
+    }
+
+    Future<bool> DownloadSongZipAsync(WebUtils::URLOptions urlOptions, std::filesystem::path outputPath, std::function<void(float)> progressReport, std::stop_token stopToken) {
+        return Executor::GetInstance().Submit([urlOptions = std::move(urlOptions), outputPath = std::move(outputPath), progressReport = std::move(progressReport), stopToken]() {
+            return DownloadSongZip(urlOptions, outputPath, progressReport, stopToken);
+        });
+    }
+
+    /// @brief extracts into a staging folder and only moves the result into outputPath once all of it was extracted and verified, so a failure leaves outputPath alone
+    template<typename T>
+    static bool ExtractStaged(T const& zip, std::filesystem::path const& outputPath, std::string_view hash) {
+        // named after the whole output path, downloads only share a staging folder when they share the output folder, and those don't run at once
+        auto stagingPath = GetDataPath() / "staging" / fmt::format("zip-{:016x}", std::hash<std::string>{}(outputPath.string()));
+
+        std::error_code ec;
+        std::filesystem::remove_all(stagingPath, ec);
+        if (!Utils::ExtractAll(zip, stagingPath, hash) || !Utils::MoveDirectory(stagingPath, outputPath)) {
+            std::filesystem::remove_all(stagingPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    static bool DownloadSongZipUnshared(WebUtils::URLOptions const& urlOptions, std::filesystem::path const& outputPath, std::function<void(float)> progressReport, std::stop_token stopToken) {
+        auto hash = ZipStore::HashFromURL(urlOptions.url);
+        if (hash.has_value()) {
+            if (auto storedZip = ZipStore::Find(hash.value())) {
+                if (ExtractStaged(*storedZip, outputPath, hash.value())) {
+                    if (progressReport) progressReport(1.0f);
+                    return true;
+                }
+                WARNING("Stored zip for {} is broken, downloading it again", hash.value());
+                ZipStore::Remove(hash.value());
+            }
+        }
+
+        auto data = Fetch<WebUtils::DataResponse>(urlOptions, progressReport, stopToken);
         if (!data.IsSuccessful() || !data.DataParsedSuccessful()) return false;
+        if (stopToken.stop_requested()) return false;
         auto& zipData = data.responseData.value();
 
-        return Utils::ExtractAll(zipData, outputPath);
+        // the hash only comes from the url, so the zip is checked against it before it's stored under it
+        if (!ExtractStaged(std::span<uint8_t const>(zipData), outputPath, hash.value_or(""))) return false;
+        if (hash.has_value()) ZipStore::Add(hash.value(), zipData);
+        return true;
+    }
+
+    bool DownloadSongZip(WebUtils::URLOptions urlOptions, std::filesystem::path outputPath, std::function<void(float)> progressReport, std::stop_token stopToken) {
+        if (stopToken.stop_requested()) return false;
+
+        // two downloads into the same output path would extract over each other
+        static Utils::SingleFlight<bool> inFlightDownloads;
+        return inFlightDownloads.Run(outputPath.string(), std::move(progressReport), stopToken, [&](std::function<void(float)> progress, std::stop_token sharedToken) {
+            return DownloadSongZipUnshared(urlOptions, outputPath, progress, sharedToken);
+        }).value_or(false);
     }
 
     std::string timestamp_string(std::chrono::time_point<std::chrono::system_clock> timepoint) {
@@ -296,14 +782,162 @@ namespace BeatSaver::API {
         return tags;
     }
 
+    /// @brief extracts the zip into a staging dir and moves it to the output path once it verified, so a broken map never shows up in the output path
+    template<typename T>
+    static std::optional<std::filesystem::path> InstallBeatmap(BeatmapDownloadInfo const& info, T const& zip) {
+        auto folderName = Utils::ReplaceIllegalCharsInPath(info.FolderName);
+        auto targetPath = GetDefaultOutputPath() / folderName;
+        auto stagingPath = GetDataPath() / "staging" / folderName;
+
+        std::error_code ec;
+        std::filesystem::remove_all(stagingPath, ec);
+        if (!Utils::ExtractAll(zip, stagingPath, info.Hash)) {
+            ERROR("Failed to extract {}, or its hash did not match {}", info.Key, info.Hash);
+            std::filesystem::remove_all(stagingPath, ec);
+            return std::nullopt;
+        }
+
+        if (!Utils::MoveDirectory(stagingPath, targetPath)) {
+            std::filesystem::remove_all(stagingPath, ec);
+            return std::nullopt;
+        }
+
+        if (!info.Hash.empty()) {
+            InstalledManifest::Add({
+                .key = info.Key,
+                .hash = info.Hash,
+                .folder = targetPath,
+                .size = InstalledManifest::GetFolderSize(targetPath),
+            });
+        }
+
+        return targetPath;
+    }
+
     bool DownloadBeatmapResponse::AcceptData(std::span<uint8_t const> data) {
-        auto basePath = GetDefaultOutputPath();
-        auto targetPath = basePath / Utils::ReplaceIllegalCharsInPath(info.FolderName);
-        if (Utils::ExtractAll(data, targetPath)) {
-            responseData = targetPath;
-            return true;
+        responseData = InstallBeatmap(info, data);
+        if (responseData.has_value() && !info.Hash.empty()) ZipStore::Add(info.Hash, data);
+        return responseData.has_value();
+    }
+
+    static std::optional<std::filesystem::path> DownloadBeatmapUnshared(BeatmapDownloadInfo const& info, std::function<void(float)> progressReport, std::stop_token stopToken) {
+        if (GetSkipInstalledMaps()) {
+            if (auto installed = GetInstalledMapPath(info.Hash)) {
+                DEBUG("{} is installed already at {}, skipping it", info.Key, installed->string());
+                if (progressReport) progressReport(1.0f);
+                return installed;
+            }
         }
-        return false;
+
+        if (auto storedZip = ZipStore::Find(info.Hash)) {
+            if (auto result = InstallBeatmap(info, *storedZip)) {
+                if (progressReport) progressReport(1.0f);
+                return result;
+            }
+            WARNING("Stored zip for {} is broken, downloading it again", info.Key);
+            ZipStore::Remove(info.Hash);
+        }
+
+        if (GetDownloadChunkSize() == 0) {
+            std::optional<std::filesystem::path> result = std::nullopt;
+            RetryRequest([&]() {
+                if (Detail::ShouldShortCircuit()) return std::pair<long, int>(0, OfflineCurlStatus);
+                // a fresh response each attempt, so nothing of a failed one is left in it
+                auto [options, response] = DownloadBeatmapURLOptionsAndResponse(info);
+                if (!AcquireRequestSlot(options.url, stopToken)) return std::pair<long, int>(0, CancelledCurlStatus);
+                GetBeatsaverDownloader().GetInto(options, &response, progressReport);
+                ReportRequestResult(options.url, response.HttpCode, response.CurlStatus);
+                result = response.responseData;
+                return std::pair<long, int>(response.HttpCode, response.CurlStatus);
+            }, stopToken);
+            return result;
+        }
+
+        auto zipPath = GetDataPath() / "downloads" / fmt::format("{}.zip", info.FolderName);
+
+        // a failed download leaves its part file behind, so the next attempt for this map resumes where it stopped
+        if (!DownloadToFile(WebUtils::URLOptions(info.DownloadURL), zipPath, progressReport, stopToken)) return std::nullopt;
+        if (stopToken.stop_requested()) return std::nullopt;
+
+        auto result = InstallBeatmap(info, zipPath);
+
+        // a verified zip moves into the store, anything else is not worth keeping
+        std::error_code ec;
+        if (!result.has_value() || info.Hash.empty() || !ZipStore::Add(info.Hash, zipPath)) std::filesystem::remove(zipPath, ec);
+        return result;
+    }
+
+    std::optional<std::filesystem::path> DownloadBeatmap(BeatmapDownloadInfo info, std::function<void(float)> progressReport, std::stop_token stopToken) {
+        if (stopToken.stop_requested()) return std::nullopt;
+
+        // maps end up in the same folder when their folder name matches, so that's what concurrent downloads are shared by
+        static Utils::SingleFlight<std::optional<std::filesystem::path>> inFlightDownloads;
+        auto result = inFlightDownloads.Run(Utils::ReplaceIllegalCharsInPath(info.FolderName), std::move(progressReport), stopToken, [&info](std::function<void(float)> progress, std::stop_token sharedToken) {
+            return DownloadBeatmapUnshared(info, progress, sharedToken);
+        });
+        return result.value_or(std::nullopt);
+    }
+
+    void DownloadBeatmapAsync(BeatmapDownloadInfo info, finished_opt_function<std::filesystem::path> onFinished, std::function<void(float)> progressReport, std::stop_token stopToken) {
+        if (!onFinished) return;
+        DownloadManager::GetInstance().Enqueue(std::move(info), DownloadPriority::High, std::move(onFinished), std::move(progressReport), stopToken);
+    }
+
+    void DownloadBeatmapsAsync(std::span<BeatmapDownloadInfo const> infos, std::function<void(std::unordered_map<std::string, std::optional<std::filesystem::path>>)> onFinished, int maxConcurrency, std::function<void(int, int)> progressReport, std::stop_token stopToken) {
+        if (!onFinished) return;
+        if (infos.empty()) {
+            onFinished({});
+            return;
+        }
+
+        struct Batch {
+            std::mutex mutex;
+            std::unordered_map<std::string, std::optional<std::filesystem::path>> results;
+            int total;
+            int completed = 0;
+            std::function<void(std::unordered_map<std::string, std::optional<std::filesystem::path>>)> onFinished;
+            std::function<void(int, int)> progressReport;
+        };
+        auto batch = std::make_shared<Batch>();
+        batch->total = infos.size();
+        batch->onFinished = std::move(onFinished);
+        batch->progressReport = std::move(progressReport);
+
+        // the whole batch shares one group, so it never takes more than maxConcurrency of the manager's slots
+        std::shared_ptr<DownloadManager::Group> group = nullptr;
+        if (maxConcurrency > 0) group = std::make_shared<DownloadManager::Group>(DownloadManager::Group{.maxConcurrency = maxConcurrency});
+        auto& manager = DownloadManager::GetInstance();
+        for (auto const& info : infos) {
+            manager.Enqueue(info, DownloadPriority::Low, group, [batch, key = info.Key](std::optional<std::filesystem::path> result) {
+                std::unique_lock lock(batch->mutex);
+                batch->results[key] = std::move(result);
+                batch->completed++;
+                if (batch->progressReport) batch->progressReport(batch->total, batch->completed);
+                if (batch->completed != batch->total) return;
+
+                // the last download to end hands the batch over
+                auto results = std::move(batch->results);
+                lock.unlock();
+                batch->onFinished(std::move(results));
+            }, nullptr, stopToken);
+        }
+    }
+
+    std::unordered_map<std::string, std::optional<std::filesystem::path>> DownloadBeatmaps(std::span<BeatmapDownloadInfo const> infos, int maxConcurrency, std::function<void(int, int)> progressReport, std::stop_token stopToken) {
+        std::mutex resultMutex;
+        std::condition_variable resultAdded;
+        std::optional<std::unordered_map<std::string, std::optional<std::filesystem::path>>> results;
+
+        DownloadBeatmapsAsync(infos, [&](std::unordered_map<std::string, std::optional<std::filesystem::path>> batchResults) {
+            // notified under the lock, the waiting thread owns these locals and returns as soon as the results are in
+            std::unique_lock lock(resultMutex);
+            results = std::move(batchResults);
+            resultAdded.notify_one();
+        }, maxConcurrency, std::move(progressReport), stopToken);
+
+        std::unique_lock lock(resultMutex);
+        resultAdded.wait(lock, [&]() { return results.has_value(); });
+        return std::move(results.value());
     }
 
     std::string BeatmapDownloadInfo::SanitizeFolderName(std::string_view str) {
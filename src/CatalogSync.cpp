@@ -0,0 +1,204 @@
+#include "CatalogSync.hpp"
+#include "PageCursor.hpp"
+#include "logging.hpp"
+#include "beatsaber-hook/shared/config/rapidjson-utils.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace BeatSaver::API {
+    // every map was updated after this
+    static constexpr std::string_view CatalogStart = "1970-01-01T00:00:00Z";
+
+    // two syncs walking the same mark would apply every page twice
+    static std::mutex syncMutex;
+
+    static std::filesystem::path GetStatePath(std::filesystem::path const& statePath) {
+        if (!statePath.empty()) return statePath;
+        return GetDataPath() / "catalog_sync.json";
+    }
+
+    /// @brief where a sync got to. after is exclusive, so the next sync asks from a bit before the mark and skips the maps at the mark it applied already
+    struct SyncState {
+        std::optional<std::string> highWaterMark = std::nullopt;
+        /// @brief the maps applied whose update time is the mark
+        std::unordered_set<std::string> boundaryIds;
+    };
+
+    /// @brief orders two update times, as times when both parse and as text otherwise
+    static int CompareTimes(std::string const& lhs, std::string const& rhs) {
+        auto lhsTime = Detail::ParseTimestamp(lhs);
+        auto rhsTime = Detail::ParseTimestamp(rhs);
+        if (lhsTime.has_value() && rhsTime.has_value()) return lhsTime < rhsTime ? -1 : (lhsTime > rhsTime ? 1 : 0);
+        return lhs.compare(rhs);
+    }
+
+    /// @brief whether the map was applied by this or an earlier sync, every map up to the mark was except the ones at the mark not in boundaryIds
+    static bool IsApplied(SyncState const& state, std::optional<std::string> const& updatedAt, std::string const& id) {
+        if (!state.highWaterMark.has_value() || !updatedAt.has_value()) return false;
+        auto order = CompareTimes(updatedAt.value(), state.highWaterMark.value());
+        return order < 0 || (order == 0 && state.boundaryIds.contains(id));
+    }
+
+    static void MarkApplied(SyncState& state, std::optional<std::string> const& updatedAt, std::string const& id) {
+        if (!updatedAt.has_value()) return;
+        auto order = state.highWaterMark.has_value() ? CompareTimes(updatedAt.value(), state.highWaterMark.value()) : 1;
+        if (order > 0) {
+            state.highWaterMark = updatedAt;
+            state.boundaryIds.clear();
+        }
+        if (order >= 0) state.boundaryIds.emplace(id);
+    }
+
+    static SyncState LoadState(std::filesystem::path const& statePath) {
+        std::ifstream file(statePath, std::ios::in | std::ios::binary);
+        if (!file.is_open()) return {};
+        std::stringstream contents;
+        contents << file.rdbuf();
+        auto json = contents.str();
+
+        rapidjson::Document doc;
+        doc.Parse(json.c_str(), json.size());
+        if (doc.HasParseError() || !doc.IsObject()) {
+            WARNING("Catalog sync state is broken, syncing from the start");
+            return {};
+        }
+
+        SyncState state;
+        auto mark = doc.FindMember("highWaterMark");
+        if (mark == doc.MemberEnd() || !mark->value.IsString()) return {};
+        state.highWaterMark = mark->value.GetString();
+
+        // older state files don't have them, the maps at the mark are applied once more then
+        auto ids = doc.FindMember("boundaryIds");
+        if (ids != doc.MemberEnd() && ids->value.IsArray()) {
+            for (auto const& id : ids->value.GetArray()) {
+                if (id.IsString()) state.boundaryIds.emplace(id.GetString());
+            }
+        }
+        return state;
+    }
+
+    static void SaveState(std::filesystem::path const& statePath, SyncState const& state) {
+        if (!state.highWaterMark.has_value()) return;
+
+        rapidjson::Document doc;
+        doc.SetObject();
+        auto& allocator = doc.GetAllocator();
+        doc.AddMember("highWaterMark", rapidjson::Value(state.highWaterMark.value(), allocator), allocator);
+        rapidjson::Value ids;
+        ids.SetArray();
+        for (auto const& id : state.boundaryIds) ids.PushBack(rapidjson::Value(id, allocator), allocator);
+        doc.AddMember("boundaryIds", ids, allocator);
+
+        rapidjson::StringBuffer buf;
+        rapidjson::Writer writer(buf);
+        doc.Accept(writer);
+
+        // same as the installed manifest, a crash halfway through a write shouldn't lose the mark
+        auto tempPath = statePath;
+        tempPath += ".tmp";
+
+        std::error_code ec;
+        std::filesystem::create_directories(statePath.parent_path(), ec);
+        {
+            std::ofstream of(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            of.write(buf.GetString(), buf.GetLength());
+            if (!of.good()) {
+                WARNING("Could not write the catalog sync state");
+                return;
+            }
+        }
+        std::filesystem::rename(tempPath, statePath, ec);
+    }
+
+    CatalogSyncResult SyncCatalog(std::function<void(std::span<Models::Beatmap const>)> apply, CatalogSyncOptions options, std::stop_token stopToken) {
+        std::unique_lock lock(syncMutex);
+        auto statePath = GetStatePath(options.statePath);
+
+        auto state = LoadState(statePath);
+        CatalogSyncResult result;
+        result.highWaterMark = state.highWaterMark;
+
+        LatestQueryOptions queryOptions;
+        queryOptions.sortOrder = LatestSortOrder::Updated;
+        queryOptions.pageSize = options.pageSize;
+        queryOptions.automapper = options.automapper;
+        queryOptions.verified = options.verified;
+        // with only after set the latest maps come oldest first, so the cursor walks forward from the mark.
+        // it starts a bit before it, maps updated at the same time as the mark may not have fit on the last page
+        queryOptions.after = result.highWaterMark.value_or(std::string(CatalogStart));
+        if (auto mark = Detail::ParseTimestamp(result.highWaterMark.value_or(""))) queryOptions.after = Detail::FormatTimestamp(mark.value() - Detail::PageBoundaryOverlap);
+
+        auto cursor = GetLatestCursor(std::move(queryOptions), options.readAhead);
+        while (!stopToken.stop_requested()) {
+            auto page = cursor.Next(stopToken);
+            if (!page.has_value()) {
+                result.complete = !stopToken.stop_requested();
+                break;
+            }
+            result.pages++;
+
+            if (!page->IsSuccessful() || !page->responseData.has_value()) {
+                result.httpCode = page->HttpCode;
+                result.curlStatus = page->CurlStatus;
+                WARNING("Catalog sync stopped at {}, request failed with http code {} curl status {}", result.highWaterMark.value_or(std::string(CatalogStart)), page->HttpCode, page->CurlStatus);
+                break;
+            }
+
+            // the first page reaches back over the saved mark, the maps there were applied by an earlier sync
+            std::vector<Models::Beatmap> changed;
+            for (auto const& map : page->responseData->GetDocs()) {
+                auto updatedAt = map.GetUpdatedAt();
+                auto id = map.GetId();
+                if (IsApplied(state, updatedAt, id)) continue;
+                MarkApplied(state, updatedAt, id);
+                changed.emplace_back(map);
+            }
+
+            if (apply && !changed.empty()) apply(changed);
+            result.changed += changed.size();
+
+            if (!changed.empty()) {
+                result.highWaterMark = state.highWaterMark;
+                SaveState(statePath, state);
+            }
+
+            if (!cursor.HasNext()) {
+                result.complete = true;
+                break;
+            }
+        }
+
+        INFO("Catalog sync applied {} changed maps over {} pages", result.changed, result.pages);
+        return result;
+    }
+
+    Future<CatalogSyncResult> SyncCatalogAsync(std::function<void(std::span<Models::Beatmap const>)> apply, CatalogSyncOptions options, std::stop_token stopToken) {
+        Promise<CatalogSyncResult> promise;
+        auto future = promise.GetFuture();
+        std::thread([promise, apply = std::move(apply), options = std::move(options), stopToken]() mutable {
+            try {
+                promise.SetValue(SyncCatalog(std::move(apply), std::move(options), stopToken));
+            } catch (...) {
+                promise.SetException(std::current_exception());
+            }
+        }).detach();
+        return future;
+    }
+
+    std::optional<std::string> GetCatalogHighWaterMark(std::filesystem::path statePath) {
+        std::unique_lock lock(syncMutex);
+        return LoadState(GetStatePath(statePath)).highWaterMark;
+    }
+
+    void ResetCatalogSync(std::filesystem::path statePath) {
+        std::unique_lock lock(syncMutex);
+        std::error_code ec;
+        std::filesystem::remove(GetStatePath(statePath), ec);
+    }
+}
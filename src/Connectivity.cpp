@@ -0,0 +1,92 @@
+#include "BeatSaver.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace BeatSaver::API {
+    static std::atomic<OfflineMode> _offlineMode = OfflineMode::Disabled;
+    static std::atomic<std::chrono::milliseconds> _offlineProbeInterval = std::chrono::milliseconds(15000);
+
+    // one failure can be a fluke, two in a row means the network or the api is down
+    static constexpr int OfflineThreshold = 2;
+
+    static std::mutex connectivityMutex;
+    static int consecutiveFailures = 0;
+    static bool offline = false;
+    // when the next request is let through to check whether beatsaver is back
+    static std::chrono::steady_clock::time_point nextProbe;
+
+    void SetOfflineMode(OfflineMode mode) {
+        _offlineMode = mode;
+    }
+
+    OfflineMode GetOfflineMode() {
+        return _offlineMode;
+    }
+
+    void SetOfflineProbeInterval(std::chrono::milliseconds interval) {
+        _offlineProbeInterval = std::max(interval, std::chrono::milliseconds(0));
+    }
+
+    std::chrono::milliseconds GetOfflineProbeInterval() {
+        return _offlineProbeInterval;
+    }
+
+    bool IsOffline() {
+        switch (GetOfflineMode()) {
+            case OfflineMode::Disabled: return false;
+            case OfflineMode::Forced: return true;
+            default: break;
+        }
+        std::unique_lock lock(connectivityMutex);
+        return offline;
+    }
+
+    bool Detail::IsConnectivityFailure(long httpCode, int curlStatus) {
+        switch (curlStatus) {
+            case 0: break;
+            // proxy and host resolving, connecting, timeouts, tls handshakes, and connections that dropped
+            case 5: case 6: case 7: case 28: case 35: case 52: case 55: case 56: return true;
+            default: return false;
+        }
+        // gateway errors come from in front of the api when it's down, 503 is left to the rate limiter
+        return httpCode == 502 || httpCode == 504 || (httpCode >= 520 && httpCode <= 524);
+    }
+
+    bool Detail::ShouldShortCircuit() {
+        switch (GetOfflineMode()) {
+            case OfflineMode::Disabled: return false;
+            case OfflineMode::Forced: return true;
+            default: break;
+        }
+
+        std::unique_lock lock(connectivityMutex);
+        if (!offline) return false;
+        auto now = std::chrono::steady_clock::now();
+        if (now < nextProbe) return true;
+        // pushed back right away, so only one request per interval checks, even if it never gets to report back
+        nextProbe = now + GetOfflineProbeInterval();
+        return false;
+    }
+
+    void Detail::ReportConnectivity(long httpCode, int curlStatus) {
+        if (GetOfflineMode() != OfflineMode::Automatic || curlStatus == CancelledCurlStatus) return;
+
+        std::unique_lock lock(connectivityMutex);
+        if (!IsConnectivityFailure(httpCode, curlStatus)) {
+            if (offline) INFO("BeatSaver can be reached again");
+            consecutiveFailures = 0;
+            offline = false;
+            return;
+        }
+
+        consecutiveFailures++;
+        if (!offline && consecutiveFailures < OfflineThreshold) return;
+        if (!offline) WARNING("BeatSaver can't be reached (http {} curl {}), answering from local caches for now", httpCode, curlStatus);
+
+        offline = true;
+        nextProbe = std::chrono::steady_clock::now() + GetOfflineProbeInterval();
+    }
+}
@@ -0,0 +1,352 @@
+#include "DownloadManager.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace BeatSaver::API {
+    // how many ended downloads are remembered for GetStatus, everything else about them is gone once onFinished ran
+    static constexpr std::size_t MaxRecentStatuses = 64;
+
+    DownloadManager& DownloadManager::GetInstance() {
+        // never destroyed, workers may still be running while statics get torn down
+        static auto instance = new DownloadManager();
+        return *instance;
+    }
+
+    DownloadManager::DownloadId DownloadManager::Enqueue(BeatmapDownloadInfo info, DownloadPriority priority, finished_opt_function<std::filesystem::path> onFinished, progress_function progressReport, std::stop_token stopToken) {
+        return Enqueue(std::move(info), priority, nullptr, std::move(onFinished), std::move(progressReport), stopToken);
+    }
+
+    DownloadManager::DownloadId DownloadManager::Enqueue(BeatmapDownloadInfo info, DownloadPriority priority, std::shared_ptr<Group> group, finished_opt_function<std::filesystem::path> onFinished, progress_function progressReport, std::stop_token stopToken) {
+        std::unique_lock lock(mutex);
+        auto id = nextId++;
+        auto item = std::make_shared<Item>(Item{
+            .id = id,
+            .info = std::move(info),
+            .priority = priority,
+            .sequence = nextSequence++,
+            .group = std::move(group),
+            .onFinished = std::move(onFinished),
+            .progressReport = std::move(progressReport),
+        });
+        items.emplace(id, item);
+        queue.emplace(item);
+
+        SpawnWorkers();
+        itemsChanged.notify_one();
+        lock.unlock();
+
+        if (stopToken.stop_possible()) {
+            // an already stopped token cancels right here, which takes the lock
+            auto onStop = std::make_unique<StopCallback>(stopToken, [this, id]() { Cancel(id); });
+
+            lock.lock();
+            bool done = item->state == DownloadState::Finished || item->state == DownloadState::Failed || item->state == DownloadState::Cancelled;
+            if (!done) item->onStop = std::move(onStop);
+            lock.unlock();
+        }
+        return id;
+    }
+
+    bool DownloadManager::Pause(DownloadId id) {
+        std::unique_lock lock(mutex);
+        auto itr = items.find(id);
+        if (itr == items.end()) return false;
+
+        auto& item = *itr->second;
+        switch (item.state) {
+            case DownloadState::Queued: {
+                queue.erase(itr->second);
+                item.state = DownloadState::Paused;
+            } return true;
+            case DownloadState::Downloading: {
+                item.pauseRequested = true;
+                item.stopSource.request_stop();
+            } return true;
+            case DownloadState::Paused: return true;
+            default: return false;
+        }
+    }
+
+    bool DownloadManager::Resume(DownloadId id) {
+        std::unique_lock lock(mutex);
+        auto itr = items.find(id);
+        if (itr == items.end()) return false;
+
+        auto& item = *itr->second;
+        // resuming before a running download got to stop just keeps it going
+        if (item.state == DownloadState::Downloading && item.pauseRequested) {
+            item.pauseRequested = false;
+            return true;
+        }
+        if (item.state != DownloadState::Paused) return false;
+
+        item.state = DownloadState::Queued;
+        queue.emplace(itr->second);
+        itemsChanged.notify_one();
+        return true;
+    }
+
+    bool DownloadManager::Cancel(DownloadId id) {
+        finished_opt_function<std::filesystem::path> onFinished;
+        std::unique_ptr<StopCallback> onStop;
+        {
+            std::unique_lock lock(mutex);
+            auto itr = items.find(id);
+            if (itr == items.end()) return false;
+
+            auto& item = *itr->second;
+            switch (item.state) {
+                case DownloadState::Queued:
+                case DownloadState::Paused: {
+                    queue.erase(itr->second);
+                    item.state = DownloadState::Cancelled;
+                    onFinished = std::move(item.onFinished);
+                    onStop = std::move(item.onStop);
+                    Retire(item);
+                } break;
+                case DownloadState::Downloading: {
+                    // the worker reports the cancellation once the download stopped
+                    item.pauseRequested = false;
+                    item.stopSource.request_stop();
+                } return true;
+                default: return false;
+            }
+        }
+
+        if (onFinished) onFinished(std::nullopt);
+        return true;
+    }
+
+    bool DownloadManager::SetPriority(DownloadId id, DownloadPriority priority) {
+        std::unique_lock lock(mutex);
+        auto itr = items.find(id);
+        if (itr == items.end()) return false;
+
+        auto& item = *itr->second;
+        if (item.state != DownloadState::Queued && item.state != DownloadState::Paused) return false;
+        // the queue is ordered by priority, so the item moves to its new place
+        bool queued = queue.erase(itr->second) > 0;
+        item.priority = priority;
+        if (queued) queue.emplace(itr->second);
+        return true;
+    }
+
+    DownloadStatus DownloadManager::ToStatus(Item const& item) {
+        return {
+            .id = item.id,
+            .key = item.info.Key,
+            .priority = item.priority,
+            .state = item.state,
+            .progress = item.progress,
+            .result = item.result,
+        };
+    }
+
+    std::optional<DownloadStatus> DownloadManager::GetStatus(DownloadId id) const {
+        std::unique_lock lock(mutex);
+        auto itr = items.find(id);
+        if (itr != items.end()) return ToStatus(*itr->second);
+
+        auto ended = std::ranges::find(recent, id, &DownloadStatus::id);
+        if (ended == recent.end()) return std::nullopt;
+        return *ended;
+    }
+
+    std::vector<DownloadStatus> DownloadManager::GetStatuses() const {
+        std::unique_lock lock(mutex);
+        std::vector<DownloadStatus> statuses;
+        statuses.reserve(items.size() + recent.size());
+        for (auto const& [_, item] : items) statuses.emplace_back(ToStatus(*item));
+        statuses.insert(statuses.end(), recent.begin(), recent.end());
+        return statuses;
+    }
+
+    void DownloadManager::ClearFinished() {
+        std::unique_lock lock(mutex);
+        recent.clear();
+    }
+
+    void DownloadManager::Retire(Item const& item) {
+        recent.emplace_back(ToStatus(item));
+        if (recent.size() > MaxRecentStatuses) recent.pop_front();
+        // this may drop the last reference to the item, so the id is copied out first
+        auto id = item.id;
+        items.erase(id);
+    }
+
+    void DownloadManager::SetMaxConcurrency(int maxConcurrency) {
+        std::unique_lock lock(mutex);
+        this->maxConcurrency = std::max(maxConcurrency, 1);
+        adaptive.limit = std::min(adaptive.limit, this->maxConcurrency);
+        SpawnWorkers();
+        // extra workers notice they are over the limit and exit
+        itemsChanged.notify_all();
+    }
+
+    int DownloadManager::GetMaxConcurrency() const {
+        std::unique_lock lock(mutex);
+        return maxConcurrency;
+    }
+
+    void DownloadManager::SetAdaptiveConcurrency(bool enabled) {
+        std::unique_lock lock(mutex);
+        adaptive.enabled = enabled;
+        SetAdaptiveLimit(adaptive.limit);
+    }
+
+    bool DownloadManager::GetAdaptiveConcurrency() const {
+        std::unique_lock lock(mutex);
+        return adaptive.enabled;
+    }
+
+    int DownloadManager::GetCurrentConcurrency() const {
+        std::unique_lock lock(mutex);
+        return GetConcurrencyLimit();
+    }
+
+    int DownloadManager::GetConcurrencyLimit() const {
+        return adaptive.enabled ? std::min(adaptive.limit, maxConcurrency) : maxConcurrency;
+    }
+
+    bool DownloadManager::HasQueued() const {
+        return !queue.empty();
+    }
+
+    void DownloadManager::SetAdaptiveLimit(int limit) {
+        adaptive.limit = std::clamp(limit, 1, maxConcurrency);
+        adaptive.windowStart = std::chrono::steady_clock::now();
+        adaptive.windowBytes = 0;
+        adaptive.windowTimeToFirstByte = {};
+        adaptive.windowTransfers = 0;
+
+        SpawnWorkers();
+        itemsChanged.notify_all();
+    }
+
+    // how long transfers are measured before the limit is reconsidered
+    static constexpr auto AdaptiveWindow = std::chrono::seconds(3);
+    // after halving, no other decrease happens for this long, so one burst of 429s doesn't drop the limit to 1
+    static constexpr auto AdaptiveDecreaseCooldown = std::chrono::seconds(10);
+
+    void DownloadManager::ReportTransfer(std::size_t bytes, std::chrono::steady_clock::duration timeToFirstByte, std::chrono::steady_clock::duration duration, long httpCode) {
+        std::unique_lock lock(mutex);
+        if (!adaptive.enabled) return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (httpCode == 429 || httpCode == 503) {
+            if (now - adaptive.lastDecrease < AdaptiveDecreaseCooldown) return;
+            adaptive.lastDecrease = now;
+            adaptive.lastChangeWasIncrease = false;
+            adaptive.previousThroughput = 0;
+            DEBUG("Got {}, lowering download concurrency to {}", httpCode, std::max(adaptive.limit / 2, 1));
+            SetAdaptiveLimit(adaptive.limit / 2);
+            return;
+        }
+
+        adaptive.windowBytes += bytes;
+        adaptive.windowTimeToFirstByte += timeToFirstByte;
+        adaptive.windowTransfers++;
+        auto elapsed = now - adaptive.windowStart;
+        if (elapsed < AdaptiveWindow) return;
+
+        auto throughput = adaptive.windowBytes / std::chrono::duration<double>(elapsed).count();
+        auto averageTimeToFirstByte = adaptive.windowTimeToFirstByte / adaptive.windowTransfers;
+        if (!adaptive.baseTimeToFirstByte.has_value() || averageTimeToFirstByte < adaptive.baseTimeToFirstByte.value()) adaptive.baseTimeToFirstByte = averageTimeToFirstByte;
+
+        auto limit = adaptive.limit;
+        // requests waiting on the server much longer than usual means the link is congested, even without errors
+        bool congested = averageTimeToFirstByte > std::max(adaptive.baseTimeToFirstByte.value() * 2, std::chrono::steady_clock::duration(std::chrono::milliseconds(250)));
+        if (congested && now - adaptive.lastDecrease >= AdaptiveDecreaseCooldown) {
+            adaptive.lastDecrease = now;
+            adaptive.lastChangeWasIncrease = false;
+            limit = limit / 2;
+        } else if (adaptive.lastChangeWasIncrease && throughput < adaptive.previousThroughput * 1.05) {
+            // the extra download didn't buy any throughput, so go back
+            adaptive.lastChangeWasIncrease = false;
+            limit--;
+        } else if (!congested && HasQueued()) {
+            adaptive.lastChangeWasIncrease = true;
+            limit++;
+        }
+
+        adaptive.previousThroughput = throughput;
+        if (limit != adaptive.limit) DEBUG("Download throughput {:.0f} B/s, changing download concurrency from {} to {}", throughput, adaptive.limit, std::clamp(limit, 1, maxConcurrency));
+        SetAdaptiveLimit(limit);
+    }
+
+    void DownloadManager::SpawnWorkers() {
+        for (; workerCount < GetConcurrencyLimit(); workerCount++) {
+            std::thread(&DownloadManager::Work, this).detach();
+        }
+    }
+
+    std::shared_ptr<DownloadManager::Item> DownloadManager::TakeNext() {
+        // only items whose group is at its limit are passed over
+        auto itr = std::ranges::find_if(queue, [](auto const& item) { return !item->group || item->group->running < item->group->maxConcurrency; });
+        if (itr == queue.end()) return nullptr;
+
+        auto next = *itr;
+        queue.erase(itr);
+        return next;
+    }
+
+    void DownloadManager::Work() {
+        std::unique_lock lock(mutex);
+        while (true) {
+            std::shared_ptr<Item> item = nullptr;
+            itemsChanged.wait(lock, [&]() {
+                if (workerCount > GetConcurrencyLimit()) return true;
+                item = TakeNext();
+                return item != nullptr;
+            });
+
+            if (workerCount > GetConcurrencyLimit()) {
+                workerCount--;
+                return;
+            }
+
+            item->state = DownloadState::Downloading;
+            item->stopSource = std::stop_source();
+            item->pauseRequested = false;
+            if (item->group) item->group->running++;
+            auto stopToken = item->stopSource.get_token();
+            lock.unlock();
+
+            auto result = DownloadBeatmap(item->info, [this, item](float progress) {
+                {
+                    std::unique_lock lock(mutex);
+                    item->progress = progress;
+                }
+                if (item->progressReport) item->progressReport(progress);
+            }, stopToken);
+
+            lock.lock();
+            if (item->group) item->group->running--;
+
+            finished_opt_function<std::filesystem::path> onFinished = nullptr;
+            std::unique_ptr<StopCallback> onStop = nullptr;
+            if (stopToken.stop_requested() && !result.has_value() && item->pauseRequested) {
+                item->state = DownloadState::Paused;
+            } else {
+                if (result.has_value()) item->state = DownloadState::Finished;
+                else if (stopToken.stop_requested()) item->state = DownloadState::Cancelled;
+                else item->state = DownloadState::Failed;
+                item->result = result;
+                onFinished = std::move(item->onFinished);
+                onStop = std::move(item->onStop);
+                Retire(*item);
+            }
+            // a slot, and maybe a group slot, is free again
+            itemsChanged.notify_all();
+
+            if (onFinished || onStop) {
+                lock.unlock();
+                onStop.reset();
+                if (onFinished) onFinished(result);
+                lock.lock();
+            }
+        }
+    }
+}
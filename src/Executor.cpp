@@ -0,0 +1,145 @@
+#include "Executor.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace BeatSaver::API {
+    // set on the executor's threads, lets Post notice it's called from inside a task
+    static thread_local bool isExecutorThread = false;
+
+    Executor& Executor::GetInstance() {
+        // never destroyed, workers may still be running while statics get torn down
+        static auto instance = new Executor();
+        return *instance;
+    }
+
+    bool Executor::IsExecutorThread() {
+        return isExecutorThread;
+    }
+
+    void Executor::Post(std::function<void()> task) {
+        if (!task) return;
+
+        std::unique_lock lock(mutex);
+        if (tasks.size() >= maxQueueSize) {
+            if (isExecutorThread) {
+                lock.unlock();
+                task();
+                return;
+            }
+            // other threads are often the main thread calling an async endpoint, which mustn't freeze, so the queue grows past the limit for them
+            if (!overflowing) WARNING("Executor queue is over its limit of {} tasks, queueing anyway", maxQueueSize);
+            overflowing = true;
+        } else {
+            overflowing = false;
+        }
+
+        tasks.emplace_back(std::move(task));
+        // only start a thread if nobody is free to pick the task up
+        if (idleCount < (int)tasks.size() && workerCount < threadCount) {
+            workerCount++;
+            std::thread(&Executor::Work, this).detach();
+        }
+        taskAdded.notify_one();
+    }
+
+    void Executor::PostDelayed(std::chrono::milliseconds delay, std::function<void()> task) {
+        if (!task) return;
+
+        std::unique_lock lock(mutex);
+        delayedTasks.emplace(std::chrono::steady_clock::now() + delay, std::move(task));
+        if (!timerRunning) {
+            timerRunning = true;
+            std::thread(&Executor::KeepTime, this).detach();
+        }
+        delayedChanged.notify_one();
+    }
+
+    void Executor::KeepTime() {
+        // counts as one of the executor's threads, so what the tasks post can't block it
+        isExecutorThread = true;
+
+        std::unique_lock lock(mutex);
+        while (true) {
+            if (delayedTasks.empty()) {
+                delayedChanged.wait(lock);
+                continue;
+            }
+
+            // a copy, the entry may be gone by the time the wait is over
+            auto due = delayedTasks.begin()->first;
+            if (std::chrono::steady_clock::now() < due) {
+                delayedChanged.wait_until(lock, due);
+                continue;
+            }
+
+            auto task = std::move(delayedTasks.begin()->second);
+            delayedTasks.erase(delayedTasks.begin());
+            lock.unlock();
+
+            try {
+                task();
+            } catch (std::exception const& e) {
+                ERROR("Uncaught exception in delayed executor task: {}", e.what());
+            } catch (...) {
+                ERROR("Uncaught exception in delayed executor task");
+            }
+
+            lock.lock();
+        }
+    }
+
+    void Executor::Work() {
+        isExecutorThread = true;
+
+        std::unique_lock lock(mutex);
+        while (true) {
+            idleCount++;
+            taskAdded.wait(lock, [this]() { return !tasks.empty() || workerCount > threadCount; });
+            idleCount--;
+
+            if (workerCount > threadCount) {
+                workerCount--;
+                return;
+            }
+
+            auto task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+
+            try {
+                task();
+            } catch (std::exception const& e) {
+                ERROR("Uncaught exception in executor task: {}", e.what());
+            } catch (...) {
+                ERROR("Uncaught exception in executor task");
+            }
+
+            lock.lock();
+        }
+    }
+
+    void Executor::SetThreadCount(int threadCount) {
+        std::unique_lock lock(mutex);
+        this->threadCount = std::max(threadCount, 1);
+        // extra workers notice they are over the limit and exit
+        taskAdded.notify_all();
+    }
+
+    int Executor::GetThreadCount() const {
+        std::unique_lock lock(mutex);
+        return threadCount;
+    }
+
+    void Executor::SetMaxQueueSize(std::size_t maxQueueSize) {
+        std::unique_lock lock(mutex);
+        this->maxQueueSize = std::max<std::size_t>(maxQueueSize, 1);
+    }
+
+    std::size_t Executor::GetMaxQueueSize() const {
+        std::unique_lock lock(mutex);
+        return maxQueueSize;
+    }
+}
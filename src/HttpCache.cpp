@@ -0,0 +1,165 @@
+#include "HttpCache.hpp"
+#include "BeatSaver.hpp"
+#include "Sha1.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+
+namespace BeatSaver::HttpCache {
+    // entries are found, added and evicted from every request thread
+    static std::mutex cacheMutex;
+    // combined size of the entries, worked out by scanning the cache dir on first use
+    static std::optional<std::uintmax_t> totalSize;
+
+    // the validation time is written with a fixed width at the start of the file, so touching an entry doesn't rewrite the body
+    static constexpr std::size_t TimeWidth = 20;
+
+    // revalidating with our own clock instead of the server's Last-Modified, the margin covers clocks that are a bit ahead
+    static constexpr std::chrono::minutes ClockMargin{10};
+
+    // a clock that is further ahead than the margin gets 304s for changes it missed, so bodies are downloaded again after this no matter what
+    static constexpr std::chrono::hours MaxRevalidatedAge{24};
+
+    static std::string FormatTime(std::chrono::system_clock::time_point time) {
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+        return fmt::format("{:0{}}", seconds, TimeWidth);
+    }
+
+    static std::chrono::system_clock::time_point ParseTime(std::string const& time) {
+        return std::chrono::system_clock::time_point(std::chrono::seconds(std::strtoll(time.c_str(), nullptr, 10)));
+    }
+
+    static std::filesystem::path GetCachePath() {
+        return API::GetDataPath() / "http";
+    }
+
+    static std::filesystem::path GetEntryPath(std::string const& key) {
+        Utils::Sha1 sha;
+        sha.Update({(uint8_t const*)key.data(), key.size()});
+        return GetCachePath() / fmt::format("{}.bin", sha.HexDigest());
+    }
+
+    /// @brief deletes the least recently used entries until the cache fits the budget again, expects cacheMutex to be held
+    static void Evict(std::uintmax_t budget) {
+        struct StoredEntry {
+            std::filesystem::path path;
+            std::uintmax_t size;
+            std::filesystem::file_time_type lastUsed;
+        };
+
+        std::error_code ec;
+        std::vector<StoredEntry> stored;
+        std::uintmax_t size = 0;
+        for (auto const& entry : std::filesystem::directory_iterator(GetCachePath(), ec)) {
+            if (!entry.is_regular_file(ec) || entry.path().extension() != ".bin") continue;
+            auto entrySize = entry.file_size(ec);
+            if (ec) continue;
+            stored.push_back({entry.path(), entrySize, entry.last_write_time(ec)});
+            size += entrySize;
+        }
+
+        if (size > budget) {
+            std::ranges::sort(stored, {}, &StoredEntry::lastUsed);
+            for (auto const& entry : stored) {
+                if (size <= budget) break;
+                if (std::filesystem::remove(entry.path, ec)) size -= entry.size;
+            }
+        }
+        totalSize = size;
+    }
+
+    std::optional<Entry> Find(std::string const& key) {
+        if (API::GetHttpCacheBudget() == 0) return std::nullopt;
+
+        std::unique_lock lock(cacheMutex);
+        auto entryPath = GetEntryPath(key);
+        std::ifstream file(entryPath, std::ios::in | std::ios::binary);
+        if (!file.is_open()) return std::nullopt;
+
+        std::string validatedAt, storedAt, keySize;
+        if (!std::getline(file, validatedAt) || !std::getline(file, storedAt) || !std::getline(file, keySize)) return std::nullopt;
+
+        // the key is stored as well, so two requests with the same file name can't get each other's body
+        std::string storedKey(std::strtoull(keySize.c_str(), nullptr, 10), '\0');
+        if (!file.read(storedKey.data(), storedKey.size()) || storedKey != key) return std::nullopt;
+
+        Entry entry;
+        entry.validatedAt = ParseTime(validatedAt);
+        entry.storedAt = ParseTime(storedAt);
+        entry.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        file.close();
+
+        // the modification time doubles as the last use for eviction
+        std::error_code ec;
+        std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), ec);
+        return entry;
+    }
+
+    void Store(std::string const& key, std::span<uint8_t const> data) {
+        auto budget = API::GetHttpCacheBudget();
+        if (budget == 0 || data.size() > budget) return;
+
+        auto now = FormatTime(std::chrono::system_clock::now());
+        auto header = fmt::format("{}\n{}\n{}\n{}", now, now, key.size(), key);
+
+        std::unique_lock lock(cacheMutex);
+        if (!totalSize.has_value()) Evict(budget);
+
+        auto entryPath = GetEntryPath(key);
+        // written next to the final name first, so a half written entry never gets found
+        auto tempPath = entryPath;
+        tempPath += ".tmp";
+
+        std::error_code ec;
+        std::filesystem::create_directories(entryPath.parent_path(), ec);
+        auto replacedSize = std::filesystem::file_size(entryPath, ec);
+        if (ec) replacedSize = 0;
+        {
+            std::ofstream of(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            of.write(header.data(), header.size());
+            of.write((char const*)data.data(), data.size());
+            if (!of.good()) {
+                WARNING("Could not write {} to the http cache", key);
+                of.close();
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+        }
+        std::filesystem::rename(tempPath, entryPath, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            return;
+        }
+
+        totalSize = totalSize.value() - std::min(totalSize.value(), replacedSize) + header.size() + data.size();
+        if (totalSize.value() > budget) Evict(budget);
+    }
+
+    void Touch(std::string const& key) {
+        if (API::GetHttpCacheBudget() == 0) return;
+
+        auto validatedAt = FormatTime(std::chrono::system_clock::now());
+
+        std::unique_lock lock(cacheMutex);
+        std::fstream file(GetEntryPath(key), std::ios::in | std::ios::out | std::ios::binary);
+        if (!file.is_open()) return;
+        file.write(validatedAt.data(), validatedAt.size());
+    }
+
+    std::optional<std::string> GetIfModifiedSince(Entry const& entry) {
+        // also catches bodies stored while the clock was set ahead and then corrected
+        auto age = std::chrono::system_clock::now() - entry.storedAt;
+        if (age > MaxRevalidatedAge || age < -ClockMargin) return std::nullopt;
+
+        auto time = std::chrono::system_clock::to_time_t(entry.validatedAt - ClockMargin);
+        std::tm tm;
+        gmtime_r(&time, &tm);
+
+        char buf[64];
+        auto size = std::strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+        return std::string(buf, size);
+    }
+}
@@ -0,0 +1,141 @@
+#include "InstalledManifest.hpp"
+#include "BeatSaver.hpp"
+#include "logging.hpp"
+#include "beatsaber-hook/shared/config/rapidjson-utils.hpp"
+
+#include <cctype>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace BeatSaver::InstalledManifest {
+    static std::mutex manifestMutex;
+    // loaded on first use, keyed by lowercase hash
+    static std::optional<std::unordered_map<std::string, Entry>> entries;
+
+    static std::filesystem::path GetManifestPath() {
+        return API::GetDataPath() / "installed.json";
+    }
+
+    static std::string NormalizeHash(std::string_view hash) {
+        std::string normalized(hash);
+        for (auto& c : normalized) c = std::tolower((unsigned char)c);
+        return normalized;
+    }
+
+    /// @brief reads the manifest from disk if that didn't happen yet, expects manifestMutex to be held
+    static std::unordered_map<std::string, Entry>& GetEntries() {
+        if (entries.has_value()) return entries.value();
+        entries.emplace();
+
+        std::ifstream file(GetManifestPath(), std::ios::in | std::ios::binary);
+        if (!file.is_open()) return entries.value();
+        std::stringstream contents;
+        contents << file.rdbuf();
+        auto json = contents.str();
+
+        rapidjson::Document doc;
+        doc.Parse(json.c_str(), json.size());
+        if (doc.HasParseError() || !doc.IsArray()) {
+            WARNING("Installed map manifest is broken, starting a new one");
+            return entries.value();
+        }
+
+        for (auto const& value : doc.GetArray()) {
+            auto key = value.FindMember("key");
+            auto hash = value.FindMember("hash");
+            auto folder = value.FindMember("folder");
+            auto size = value.FindMember("size");
+            if (key == value.MemberEnd() || hash == value.MemberEnd() || folder == value.MemberEnd() || size == value.MemberEnd()) continue;
+            if (!key->value.IsString() || !hash->value.IsString() || !folder->value.IsString() || !size->value.IsUint64()) continue;
+
+            auto normalized = NormalizeHash(hash->value.GetString());
+            entries->emplace(normalized, Entry{
+                .key = key->value.GetString(),
+                .hash = normalized,
+                .folder = folder->value.GetString(),
+                .size = size->value.GetUint64(),
+            });
+        }
+
+        return entries.value();
+    }
+
+    /// @brief writes the manifest to disk, expects manifestMutex to be held
+    static void Save() {
+        rapidjson::Document doc;
+        doc.SetArray();
+        auto& allocator = doc.GetAllocator();
+
+        for (auto const& [_, entry] : GetEntries()) {
+            rapidjson::Value value;
+            value.SetObject();
+            value.AddMember("key", rapidjson::Value(entry.key, allocator), allocator);
+            value.AddMember("hash", rapidjson::Value(entry.hash, allocator), allocator);
+            value.AddMember("folder", rapidjson::Value(entry.folder.string(), allocator), allocator);
+            value.AddMember("size", rapidjson::Value(uint64_t(entry.size)), allocator);
+            doc.PushBack(value, allocator);
+        }
+
+        rapidjson::StringBuffer buf;
+        rapidjson::Writer writer(buf);
+        doc.Accept(writer);
+
+        // written next to the manifest first, a crash halfway through a write shouldn't lose every entry
+        auto manifestPath = GetManifestPath();
+        auto tempPath = manifestPath;
+        tempPath += ".tmp";
+
+        std::error_code ec;
+        std::filesystem::create_directories(manifestPath.parent_path(), ec);
+        {
+            std::ofstream of(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            of.write(buf.GetString(), buf.GetLength());
+            if (!of.good()) {
+                WARNING("Could not write the installed map manifest");
+                return;
+            }
+        }
+        std::filesystem::rename(tempPath, manifestPath, ec);
+    }
+
+    std::optional<Entry> Find(std::string_view hash) {
+        if (hash.empty()) return std::nullopt;
+
+        std::unique_lock lock(manifestMutex);
+        auto& installed = GetEntries();
+        auto itr = installed.find(NormalizeHash(hash));
+        if (itr == installed.end()) return std::nullopt;
+
+        // a single stat, the user may have deleted the map since
+        std::error_code ec;
+        if (!std::filesystem::is_directory(itr->second.folder, ec)) {
+            installed.erase(itr);
+            Save();
+            return std::nullopt;
+        }
+
+        return itr->second;
+    }
+
+    void Add(Entry entry) {
+        std::unique_lock lock(manifestMutex);
+        auto& installed = GetEntries();
+
+        // whatever was in the folder before got replaced by this install
+        std::erase_if(installed, [&entry](auto const& pair) { return pair.second.folder == entry.folder; });
+        entry.hash = NormalizeHash(entry.hash);
+        installed[entry.hash] = std::move(entry);
+        Save();
+    }
+
+    uintmax_t GetFolderSize(std::filesystem::path const& folder) {
+        std::error_code ec;
+        uintmax_t size = 0;
+        for (auto const& file : std::filesystem::recursive_directory_iterator(folder, ec)) {
+            if (file.is_regular_file(ec)) size += file.file_size(ec);
+        }
+        return size;
+    }
+}
@@ -0,0 +1,139 @@
+#include "LookupBatcher.hpp"
+#include "BeatSaver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+
+namespace BeatSaver::API {
+    static std::atomic_bool _lookupBatching = false;
+    static std::atomic<std::chrono::milliseconds> _lookupBatchWindow = std::chrono::milliseconds(10);
+
+    void SetLookupBatching(bool enabled) {
+        _lookupBatching = enabled;
+    }
+
+    bool GetLookupBatching() {
+        return _lookupBatching;
+    }
+
+    void SetLookupBatchWindow(std::chrono::milliseconds window) {
+        _lookupBatchWindow = std::max(window, std::chrono::milliseconds(0));
+    }
+
+    std::chrono::milliseconds GetLookupBatchWindow() {
+        return _lookupBatchWindow;
+    }
+
+    static std::string ToLower(std::string str) {
+        for (auto& c : str) c = std::tolower((unsigned char)c);
+        return str;
+    }
+
+    /// @brief the single lookup response for one id of a batch
+    /// @param found the result for the id, nullptr if the batch didn't have it
+    template<typename T, typename Batch, typename Value>
+    static T GetBatchEntry(Batch const& batch, std::size_t index, Value const* found) {
+        T response;
+        for (auto const& failure : batch.failedChunks) {
+            if (index < failure.offset || index >= failure.offset + failure.count) continue;
+            response.HttpCode = failure.httpCode;
+            response.CurlStatus = failure.curlStatus;
+            return response;
+        }
+
+        if (!batch.IsSuccessful() || !batch.responseData.has_value()) {
+            response.HttpCode = batch.HttpCode;
+            response.CurlStatus = batch.CurlStatus;
+        } else if (found) {
+            response.HttpCode = batch.HttpCode;
+            response.CurlStatus = batch.CurlStatus;
+            response.responseData = *found;
+        } else {
+            // what the single lookup answers for something that doesn't exist
+            response.HttpCode = 404;
+        }
+        return response;
+    }
+
+    /// @brief fetches a batch of map lookups, a batch of one uses the single endpoint since the batch endpoint answers that with a bare map
+    /// @param getIds what the maps of the response are found by, besides the key the response has them under
+    static std::vector<BeatmapResponse> FetchBeatmapLookups(std::vector<std::string> const& ids, WebUtils::URLOptions(*singleOptions)(std::string), WebUtils::URLOptions(*batchOptions)(std::span<std::string const>), std::function<std::vector<std::string>(Models::Beatmap const&)> getIds) {
+        if (ids.size() == 1) return { Fetch<BeatmapResponse>(singleOptions(ids.front())) };
+
+        auto batch = FetchBatch<BeatmapMapResponse, std::string>(ids, batchOptions);
+        std::unordered_map<std::string, Models::Beatmap const*> maps;
+        if (batch.responseData.has_value()) {
+            for (auto const& [key, map] : batch.responseData.value()) {
+                maps.emplace(ToLower(key), &map);
+                for (auto const& id : getIds(map)) maps.emplace(ToLower(id), &map);
+            }
+        }
+
+        std::vector<BeatmapResponse> responses;
+        responses.reserve(ids.size());
+        for (std::size_t i = 0; i < ids.size(); i++) {
+            auto itr = maps.find(ToLower(ids[i]));
+            responses.emplace_back(GetBatchEntry<BeatmapResponse>(batch, i, itr != maps.end() ? itr->second : nullptr));
+        }
+        return responses;
+    }
+
+    static std::vector<UserDetailResponse> FetchUserLookups(std::vector<int> const& ids) {
+        if (ids.size() == 1) return { Fetch<UserDetailResponse>(GetUserByIdURLOptions(ids.front())) };
+
+        auto batch = FetchBatch<UserDetailArrayResponse, int>(ids, &GetUsersByIdsURLOptions);
+        std::unordered_map<int, Models::UserDetail const*> users;
+        if (batch.responseData.has_value()) {
+            for (auto const& user : batch.responseData.value()) users.emplace(user.Id, &user);
+        }
+
+        std::vector<UserDetailResponse> responses;
+        responses.reserve(ids.size());
+        for (std::size_t i = 0; i < ids.size(); i++) {
+            auto itr = users.find(ids[i]);
+            responses.emplace_back(GetBatchEntry<UserDetailResponse>(batch, i, itr != users.end() ? itr->second : nullptr));
+        }
+        return responses;
+    }
+
+    /// @brief answers a lookup the negative cache knows is missing right away, instead of making it wait for the batch window
+    /// @return whether it was answered
+    template<typename T>
+    static bool AnswerKnownMissing(WebUtils::URLOptions const& urlOptions, std::function<void(T)> const& onFinished) {
+        if (GetNegativeCacheTTL().count() <= 0 || !Detail::IsKnownMissing(urlOptions)) return false;
+        T missing;
+        missing.HttpCode = 404;
+        if (onFinished) onFinished(std::move(missing));
+        return true;
+    }
+
+    void LoadBeatmapByKey(std::string key, std::function<void(BeatmapResponse)> onFinished) {
+        if (AnswerKnownMissing(GetBeatmapByKeyURLOptions(key), onFinished)) return;
+        // never destroyed, batches may still be resolving while statics get torn down
+        static auto batcher = new LookupBatcher<std::string, BeatmapResponse>([](std::vector<std::string> const& keys) {
+            return FetchBeatmapLookups(keys, &GetBeatmapByKeyURLOptions, &GetBeatmapsByKeysURLOptions, [](Models::Beatmap const& map) {
+                return std::vector<std::string>{map.Id};
+            });
+        }, &GetLookupBatchWindow);
+        batcher->Load(std::move(key), std::move(onFinished));
+    }
+
+    void LoadBeatmapByHash(std::string hash, std::function<void(BeatmapResponse)> onFinished) {
+        if (AnswerKnownMissing(GetBeatmapByHashURLOptions(hash), onFinished)) return;
+        static auto batcher = new LookupBatcher<std::string, BeatmapResponse>([](std::vector<std::string> const& hashes) {
+            return FetchBeatmapLookups(hashes, &GetBeatmapByHashURLOptions, &GetBeatmapsByHashesURLOptions, [](Models::Beatmap const& map) {
+                std::vector<std::string> versionHashes;
+                for (auto const& version : map.Versions) versionHashes.emplace_back(version.Hash);
+                return versionHashes;
+            });
+        }, &GetLookupBatchWindow);
+        batcher->Load(std::move(hash), std::move(onFinished));
+    }
+
+    void LoadUserById(int id, std::function<void(UserDetailResponse)> onFinished) {
+        if (AnswerKnownMissing(GetUserByIdURLOptions(id), onFinished)) return;
+        static auto batcher = new LookupBatcher<int, UserDetailResponse>(&FetchUserLookups, &GetLookupBatchWindow);
+        batcher->Load(id, std::move(onFinished));
+    }
+}
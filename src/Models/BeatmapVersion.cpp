@@ -3,47 +3,53 @@
 #include "Utils.hpp"
 
 namespace BeatSaver::Models {
-    std::optional<std::filesystem::path> BeatmapVersion::DownloadBeatmap(Beatmap const& beatmap, std::function<void(float)> progressReport) const {
-        return BeatSaver::API::DownloadBeatmap({beatmap, *this}, std::forward<std::function<void(float)>>(progressReport));
+    std::optional<std::filesystem::path> BeatmapVersion::DownloadBeatmap(Beatmap const& beatmap, std::function<void(float)> progressReport, std::stop_token stopToken) const {
+        return BeatSaver::API::DownloadBeatmap({beatmap, *this}, std::forward<std::function<void(float)>>(progressReport), stopToken);
     }
 
-    std::future<std::optional<std::filesystem::path>> BeatmapVersion::DownloadBeatmapAsync(Beatmap const& beatmap, std::function<void(float)> progressReport) const {
-        return std::async(std::launch::any, BeatSaver::API::DownloadBeatmap, BeatSaver::API::BeatmapDownloadInfo{beatmap, *this}, std::forward<std::function<void(float)>>(progressReport));
+    BeatSaver::API::Future<std::optional<std::filesystem::path>> BeatmapVersion::DownloadBeatmapAsync(Beatmap const& beatmap, std::function<void(float)> progressReport, std::stop_token stopToken) const {
+        return BeatSaver::API::Executor::GetInstance().Submit([info = BeatSaver::API::BeatmapDownloadInfo{beatmap, *this}, progressReport = std::move(progressReport), stopToken]() {
+            return BeatSaver::API::DownloadBeatmap(info, progressReport, stopToken);
+        });
     }
 
-    void BeatmapVersion::DownloadBeatmapAsync(Beatmap const& beatmap, std::function<void(std::optional<std::filesystem::path>)> onFinished, std::function<void(float)> progressReport) const {
-        return BeatSaver::API::DownloadBeatmapAsync({beatmap, *this}, onFinished, std::forward<std::function<void(float)>>(progressReport));
+    void BeatmapVersion::DownloadBeatmapAsync(Beatmap const& beatmap, std::function<void(std::optional<std::filesystem::path>)> onFinished, std::function<void(float)> progressReport, std::stop_token stopToken) const {
+        return BeatSaver::API::DownloadBeatmapAsync({beatmap, *this}, onFinished, std::forward<std::function<void(float)>>(progressReport), stopToken);
     }
 
-    std::optional<std::vector<uint8_t>> BeatmapVersion::GetCoverImage() const {
-        return Utils::GetData(CoverURL);
+    std::optional<std::vector<uint8_t>> BeatmapVersion::GetCoverImage(std::stop_token stopToken) const {
+        return Utils::GetAsset(CoverURL, Hash, stopToken);
     }
 
-    void BeatmapVersion::GetCoverImageAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished) const {
+    void BeatmapVersion::GetCoverImageAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished, std::stop_token stopToken) const {
         if (!onFinished) return;
 
-        std::thread([](std::string coverURL, std::function<void(std::optional<std::vector<uint8_t>>)> onFinished){
-            onFinished(Utils::GetData(coverURL));
-        }, std::forward<std::string>(CoverURL), std::forward<std::function<void(std::optional<std::vector<uint8_t>>)>>(onFinished)).detach();
+        BeatSaver::API::Executor::GetInstance().Post([coverURL = CoverURL, hash = Hash, onFinished = std::move(onFinished), stopToken]() {
+            onFinished(Utils::GetAsset(coverURL, hash, stopToken));
+        });
     }
 
-    std::future<std::optional<std::vector<uint8_t>>> BeatmapVersion::GetCoverImageAsync() const {
-        return std::async(std::launch::any, &Utils::GetData, CoverURL);
+    BeatSaver::API::Future<std::optional<std::vector<uint8_t>>> BeatmapVersion::GetCoverImageAsync(std::stop_token stopToken) const {
+        return BeatSaver::API::Executor::GetInstance().Submit([coverURL = CoverURL, hash = Hash, stopToken]() {
+            return Utils::GetAsset(coverURL, hash, stopToken);
+        });
     }
 
-    std::optional<std::vector<uint8_t>> BeatmapVersion::GetPreview() const {
-        return Utils::GetData(PreviewURL);
+    std::optional<std::vector<uint8_t>> BeatmapVersion::GetPreview(std::stop_token stopToken) const {
+        return Utils::GetAsset(PreviewURL, Hash, stopToken);
     }
 
-    void BeatmapVersion::GetPreviewAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished) const {
+    void BeatmapVersion::GetPreviewAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished, std::stop_token stopToken) const {
         if (!onFinished) return;
 
-        std::thread([](std::string previewURL, std::function<void(std::optional<std::vector<uint8_t>>)> onFinished){
-            onFinished(Utils::GetData(previewURL));
-        }, std::forward<std::string>(PreviewURL), std::forward<std::function<void(std::optional<std::vector<uint8_t>>)>>(onFinished)).detach();
+        BeatSaver::API::Executor::GetInstance().Post([previewURL = PreviewURL, hash = Hash, onFinished = std::move(onFinished), stopToken]() {
+            onFinished(Utils::GetAsset(previewURL, hash, stopToken));
+        });
     }
 
-    std::future<std::optional<std::vector<uint8_t>>> BeatmapVersion::GetPreviewAsync() const {
-        return std::async(std::launch::any, &Utils::GetData, PreviewURL);
+    BeatSaver::API::Future<std::optional<std::vector<uint8_t>>> BeatmapVersion::GetPreviewAsync(std::stop_token stopToken) const {
+        return BeatSaver::API::Executor::GetInstance().Submit([previewURL = PreviewURL, hash = Hash, stopToken]() {
+            return Utils::GetAsset(previewURL, hash, stopToken);
+        });
     }
 }
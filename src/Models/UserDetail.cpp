@@ -1,16 +1,17 @@
 #include "Models/UserDetail.hpp"
+#include "Executor.hpp"
 #include "Utils.hpp"
 
 namespace BeatSaver::Models {
-    void UserDetail::GetAvatarImageAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished) const {
+    void UserDetail::GetAvatarImageAsync(std::function<void(std::optional<std::vector<uint8_t>>)> onFinished, std::stop_token stopToken) const {
         if (!onFinished) return;
 
-        std::thread([](std::string avatarURL, std::function<void(std::optional<std::vector<uint8_t>>)> onFinished){
-            onFinished(Utils::GetData(avatarURL));
-        }, AvatarURL, std::forward<std::function<void(std::optional<std::vector<uint8_t>>)>>(onFinished)).detach();
+        BeatSaver::API::Executor::GetInstance().Post([avatarURL = AvatarURL, onFinished = std::move(onFinished), stopToken]() {
+            onFinished(Utils::GetAsset(avatarURL, {}, stopToken));
+        });
     }
 
-    std::optional<std::vector<uint8_t>> UserDetail::GetAvatarImage() const {
-        return Utils::GetData(AvatarURL);
+    std::optional<std::vector<uint8_t>> UserDetail::GetAvatarImage(std::stop_token stopToken) const {
+        return Utils::GetAsset(AvatarURL, {}, stopToken);
     }
 }
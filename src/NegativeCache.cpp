@@ -0,0 +1,99 @@
+#include "BeatSaver.hpp"
+#include "LruCache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <unordered_set>
+#include <vector>
+
+namespace BeatSaver::API {
+    static std::atomic<std::chrono::milliseconds> _negativeCacheTTL = std::chrono::milliseconds(0);
+
+    // entries are tiny, so the budget counts ids instead of bytes
+    static constexpr std::size_t MaxMissingIds = 100000;
+
+    static Utils::LruCache<std::string, bool>& GetNegativeCache() {
+        // never destroyed, requests may still be running while statics get torn down
+        static auto cache = new Utils::LruCache<std::string, bool>(MaxMissingIds);
+        return *cache;
+    }
+
+    void SetNegativeCacheTTL(std::chrono::milliseconds ttl) {
+        _negativeCacheTTL = std::max(ttl, std::chrono::milliseconds(0));
+        if (ttl.count() <= 0) GetNegativeCache().Clear();
+    }
+
+    std::chrono::milliseconds GetNegativeCacheTTL() {
+        return _negativeCacheTTL;
+    }
+
+    void ClearNegativeCache() {
+        GetNegativeCache().Clear();
+    }
+
+    /// @brief the lookup endpoints and what their ids are, single and batch endpoints of the same thing share the ids they remember
+    static constexpr std::pair<std::string_view, std::string_view> LookupPrefixes[] = {
+        {BEATSAVER_API_URL "/maps/id/", "key"},
+        {BEATSAVER_API_URL "/maps/ids/", "key"},
+        {BEATSAVER_API_URL "/maps/hash/", "hash"},
+        {BEATSAVER_API_URL "/users/id/", "user"},
+        {BEATSAVER_API_URL "/users/ids/", "user"},
+        {BEATSAVER_API_URL "/users/name/", "username"},
+    };
+
+    static std::string ToLower(std::string_view str) {
+        std::string lower(str);
+        for (auto& c : lower) c = std::tolower((unsigned char)c);
+        return lower;
+    }
+
+    /// @brief the cache keys of the ids the url looks up, empty if it isn't a lookup
+    static std::vector<std::string> GetLookupKeys(std::string_view url) {
+        std::vector<std::string> keys;
+        for (auto const& [prefix, kind] : LookupPrefixes) {
+            if (!url.starts_with(prefix)) continue;
+
+            auto ids = url.substr(prefix.size());
+            ids = ids.substr(0, ids.find_first_of("?#"));
+            while (!ids.empty()) {
+                auto comma = ids.find(',');
+                auto id = ids.substr(0, comma);
+                if (!id.empty()) keys.emplace_back(fmt::format("{}:{}", kind, ToLower(id)));
+                ids = comma == std::string_view::npos ? std::string_view() : ids.substr(comma + 1);
+            }
+            break;
+        }
+        return keys;
+    }
+
+    static void Remember(std::string key) {
+        auto ttl = GetNegativeCacheTTL();
+        if (ttl.count() <= 0) return;
+        GetNegativeCache().Insert(std::move(key), true, 1, Utils::LruCache<std::string, bool>::clock::now() + ttl);
+    }
+
+    bool Detail::IsKnownMissing(WebUtils::URLOptions const& urlOptions) {
+        auto keys = GetLookupKeys(urlOptions.url);
+        if (keys.empty()) return false;
+        auto& cache = GetNegativeCache();
+        return std::ranges::all_of(keys, [&cache](auto const& key) { return cache.Find(key).has_value(); });
+    }
+
+    void Detail::RecordMissing(WebUtils::URLOptions const& urlOptions) {
+        auto keys = GetLookupKeys(urlOptions.url);
+        // a 404 for several ids doesn't say which of them is missing
+        if (keys.size() != 1) return;
+        Remember(std::move(keys.front()));
+    }
+
+    void Detail::RecordBatchMisses(WebUtils::URLOptions const& urlOptions, std::span<std::string const> found) {
+        std::unordered_set<std::string> foundIds;
+        for (auto const& id : found) foundIds.emplace(ToLower(id));
+
+        for (auto& key : GetLookupKeys(urlOptions.url)) {
+            auto id = key.substr(key.find(':') + 1);
+            if (!foundIds.contains(id)) Remember(std::move(key));
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include "RateLimiter.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+
+namespace BeatSaver::API {
+    // a bucket never backs off below this part of its configured rate, so it can't stall completely
+    static constexpr double MinRateFraction = 1.0 / 16;
+    // part of the configured rate every successful request wins back
+    static constexpr double RecoveryFraction = 1.0 / 32;
+
+    TokenBucket::TokenBucket(RateLimit limit) : limit(limit), rate(limit.requestsPerSecond), tokens(std::max(limit.burst, 1)), lastRefill(clock::now()), pausedUntil(clock::now()) {}
+
+    void TokenBucket::Refill(clock::time_point now) {
+        auto elapsed = std::chrono::duration<double>(now - lastRefill).count();
+        tokens = std::min<double>(tokens + elapsed * rate, std::max(limit.burst, 1));
+        lastRefill = now;
+    }
+
+    bool TokenBucket::Acquire(std::stop_token stopToken) {
+        std::unique_lock lock(mutex);
+        while (!stopToken.stop_requested()) {
+            if (limit.requestsPerSecond <= 0) return true;
+
+            auto now = clock::now();
+            if (now < pausedUntil) {
+                changed.wait_until(lock, stopToken, pausedUntil, []() { return false; });
+                continue;
+            }
+
+            Refill(now);
+            if (tokens >= 1) {
+                tokens -= 1;
+                return true;
+            }
+
+            // woken early when the limit changes, the wait is worked out again then
+            auto wait = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>((1 - tokens) / rate));
+            changed.wait_for(lock, stopToken, wait, []() { return false; });
+        }
+        return false;
+    }
+
+    void TokenBucket::Report(long httpCode, int curlStatus) {
+        std::unique_lock lock(mutex);
+        if (limit.requestsPerSecond <= 0) return;
+
+        auto now = clock::now();
+        Refill(now);
+        if (curlStatus == 0 && (httpCode == 429 || httpCode == 503)) {
+            rate = std::max(rate / 2, limit.requestsPerSecond * MinRateFraction);
+            tokens = 0;
+            pausedUntil = std::max(pausedUntil, now + limit.cooldown);
+            DEBUG("Rate limited with http {}, backing off to {} requests per second", httpCode, rate);
+        } else if (curlStatus == 0 && httpCode != 0) {
+            rate = std::min(rate + limit.requestsPerSecond * RecoveryFraction, limit.requestsPerSecond);
+        }
+    }
+
+    void TokenBucket::SetLimit(RateLimit limit) {
+        std::unique_lock lock(mutex);
+        Refill(clock::now());
+        this->limit = limit;
+        rate = limit.requestsPerSecond;
+        tokens = std::min<double>(tokens, std::max(limit.burst, 1));
+        changed.notify_all();
+    }
+
+    RateLimit TokenBucket::GetLimit() {
+        std::unique_lock lock(mutex);
+        return limit;
+    }
+
+    static TokenBucket& GetBucket(RateLimitBucket bucket) {
+        // never destroyed, requests may still be running while statics get torn down
+        // beatsaver doesn't document its limits, so nothing is limited until a mod sets a limit itself
+        static auto api = new TokenBucket(RateLimit{});
+        static auto cdn = new TokenBucket(RateLimit{});
+        return bucket == RateLimitBucket::API ? *api : *cdn;
+    }
+
+    void SetRateLimit(RateLimitBucket bucket, RateLimit limit) {
+        GetBucket(bucket).SetLimit(limit);
+    }
+
+    RateLimit GetRateLimit(RateLimitBucket bucket) {
+        return GetBucket(bucket).GetLimit();
+    }
+
+    RateLimitBucket GetRateLimitBucket(std::string_view url) {
+        return url.starts_with(BEATSAVER_API_URL) ? RateLimitBucket::API : RateLimitBucket::CDN;
+    }
+
+    bool AcquireRequestSlot(std::string_view url, std::stop_token stopToken) {
+        return GetBucket(GetRateLimitBucket(url)).Acquire(stopToken);
+    }
+
+    void ReportRequestResult(std::string_view url, long httpCode, int curlStatus) {
+        GetBucket(GetRateLimitBucket(url)).Report(httpCode, curlStatus);
+        Detail::ReportConnectivity(httpCode, curlStatus);
+    }
+}
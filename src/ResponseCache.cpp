@@ -0,0 +1,111 @@
+#include "BeatSaver.hpp"
+#include "LruCache.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace BeatSaver::API {
+    static std::atomic_size_t _responseCacheBudget = 0;
+
+    static Utils::LruCache<std::string, std::shared_ptr<void const>>& GetResponseCache() {
+        // never destroyed, requests may still be running while statics get torn down
+        static auto cache = new Utils::LruCache<std::string, std::shared_ptr<void const>>();
+        return *cache;
+    }
+
+    /// @brief a response kept for stale while revalidate requests, with a hash of its json to tell whether a refresh changed anything
+    struct KeptResponse {
+        Detail::StaleResponse stale;
+        std::size_t dataHash;
+    };
+
+    static Utils::LruCache<std::string, KeptResponse>& GetStaleResponses() {
+        static auto cache = new Utils::LruCache<std::string, KeptResponse>(4 * 1024 * 1024);
+        return *cache;
+    }
+
+    static std::mutex _responseCacheTTLMutex;
+    static std::vector<std::pair<std::string, std::chrono::milliseconds>> _responseCacheTTLs = {
+        {BEATSAVER_API_URL, std::chrono::seconds(30)},
+        {BEATSAVER_API_URL "/maps/id", std::chrono::minutes(5)},
+        {BEATSAVER_API_URL "/maps/hash", std::chrono::minutes(5)},
+        {BEATSAVER_API_URL "/users/id", std::chrono::minutes(5)},
+        {BEATSAVER_API_URL "/users/name", std::chrono::minutes(5)},
+        {BEATSAVER_API_URL "/maps/uploader", std::chrono::minutes(1)},
+        {BEATSAVER_API_URL "/playlists", std::chrono::minutes(1)},
+    };
+
+    void SetResponseCacheBudget(std::size_t budget) {
+        _responseCacheBudget = budget;
+        GetResponseCache().SetBudget(budget);
+    }
+
+    std::size_t GetResponseCacheBudget() {
+        return _responseCacheBudget;
+    }
+
+    void SetStaleResponseBudget(std::size_t budget) {
+        GetStaleResponses().SetBudget(budget);
+    }
+
+    std::size_t GetStaleResponseBudget() {
+        return GetStaleResponses().GetBudget();
+    }
+
+    void SetResponseCacheTTL(std::string urlPrefix, std::chrono::milliseconds ttl) {
+        std::unique_lock lock(_responseCacheTTLMutex);
+        auto itr = std::ranges::find(_responseCacheTTLs, urlPrefix, &std::pair<std::string, std::chrono::milliseconds>::first);
+        if (itr != _responseCacheTTLs.end()) itr->second = ttl;
+        else _responseCacheTTLs.emplace_back(std::move(urlPrefix), ttl);
+    }
+
+    std::chrono::milliseconds GetResponseCacheTTL(std::string_view url) {
+        std::unique_lock lock(_responseCacheTTLMutex);
+        std::size_t longest = 0;
+        std::chrono::milliseconds ttl{0};
+        for (auto const& [prefix, prefixTTL] : _responseCacheTTLs) {
+            if (prefix.size() < longest || !url.starts_with(prefix)) continue;
+            longest = prefix.size();
+            ttl = prefixTTL;
+        }
+        return ttl;
+    }
+
+    void ClearResponseCache() {
+        GetResponseCache().Clear();
+    }
+
+    /// @brief one response can be parsed into different types, so the type is part of the key
+    static std::string GetCacheKey(std::type_index type, WebUtils::URLOptions const& urlOptions) {
+        return fmt::format("{}\n{}", type.name(), Utils::GetRequestKey(urlOptions));
+    }
+
+    std::shared_ptr<void const> Detail::FindCachedResponse(std::type_index type, WebUtils::URLOptions const& urlOptions) {
+        return GetResponseCache().Find(GetCacheKey(type, urlOptions)).value_or(nullptr);
+    }
+
+    void Detail::StoreCachedResponse(std::type_index type, WebUtils::URLOptions const& urlOptions, std::shared_ptr<void const> response, std::size_t size) {
+        auto ttl = GetResponseCacheTTL(urlOptions.url);
+        if (ttl.count() <= 0) return;
+        GetResponseCache().Insert(GetCacheKey(type, urlOptions), std::move(response), size, Utils::LruCache<std::string, std::shared_ptr<void const>>::clock::now() + ttl);
+    }
+
+    std::optional<Detail::StaleResponse> Detail::FindStaleResponse(std::type_index type, WebUtils::URLOptions const& urlOptions) {
+        auto kept = GetStaleResponses().Find(GetCacheKey(type, urlOptions));
+        if (!kept.has_value()) return std::nullopt;
+        return std::move(kept->stale);
+    }
+
+    bool Detail::StoreStaleResponse(std::type_index type, WebUtils::URLOptions const& urlOptions, std::shared_ptr<void const> response, std::span<uint8_t const> data) {
+        auto& staleResponses = GetStaleResponses();
+        auto key = GetCacheKey(type, urlOptions);
+        auto dataHash = std::hash<std::string_view>()(std::string_view((char const*)data.data(), data.size()));
+        auto previous = staleResponses.Find(key);
+
+        staleResponses.Insert(std::move(key), KeptResponse{{std::move(response), std::chrono::steady_clock::now()}, dataHash}, data.size());
+        return !previous.has_value() || previous->dataHash != dataHash;
+    }
+}
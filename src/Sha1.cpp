@@ -0,0 +1,77 @@
+#include "Sha1.hpp"
+
+#include <bit>
+#include <cstring>
+#include <fmt/format.h>
+
+namespace BeatSaver::Utils {
+    Sha1::Sha1() : state{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0} {}
+
+    void Sha1::ProcessBlock(uint8_t const* block) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) | (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+        }
+        for (int i = 16; i < 80; i++) {
+            w[i] = std::rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        auto [a, b, c, d, e] = state;
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+
+            auto temp = std::rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = std::rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+
+    void Sha1::Update(std::span<uint8_t const> data) {
+        totalSize += data.size();
+
+        // top up a partially filled block first
+        if (bufferSize > 0) {
+            auto count = std::min(data.size(), buffer.size() - bufferSize);
+            std::memcpy(buffer.data() + bufferSize, data.data(), count);
+            bufferSize += count;
+            data = data.subspan(count);
+            if (bufferSize < buffer.size()) return;
+            ProcessBlock(buffer.data());
+            bufferSize = 0;
+        }
+
+        while (data.size() >= buffer.size()) {
+            ProcessBlock(data.data());
+            data = data.subspan(buffer.size());
+        }
+
+        std::memcpy(buffer.data(), data.data(), data.size());
+        bufferSize = data.size();
+    }
+
+    std::string Sha1::HexDigest() {
+        uint64_t bitSize = totalSize * 8;
+
+        uint8_t padding[72] = { 0x80 };
+        auto paddingSize = (bufferSize < 56 ? 56 : 120) - bufferSize;
+        for (int i = 0; i < 8; i++) {
+            padding[paddingSize + i] = uint8_t(bitSize >> (56 - i * 8));
+        }
+        Update({padding, paddingSize + 8});
+
+        return fmt::format("{:08x}{:08x}{:08x}{:08x}{:08x}", state[0], state[1], state[2], state[3], state[4]);
+    }
+}
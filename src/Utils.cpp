@@ -1,14 +1,23 @@
 #include "Utils.hpp"
+#include "BeatSaver.hpp"
+#include "Sha1.hpp"
+#include "logging.hpp"
 #include "zip/shared/zip.h"
-#include "web-utils/shared/DownloaderUtility.hpp"
+#include "beatsaber-hook/shared/config/rapidjson-utils.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <fcntl.h>
 #include <fstream>
+#include <functional>
+#include <map>
+#include <thread>
+#include <unistd.h>
 #include <vector>
 
 namespace BeatSaver::Utils {
-    static const WebUtils::DownloaderUtility downloader{.userAgent=MOD_ID "/" VERSION " (+https://github.com/RedBrumbler/BeatSaverPlusPlus)"};
-
     std::vector<char> make_vec(std::string_view chars) {
         std::vector<char> vec{chars.begin(), chars.end()};
         std::sort(vec.begin(), vec.end());
@@ -24,50 +33,388 @@ namespace BeatSaver::Utils {
         return path;
     }
 
-    bool ExtractAll(std::span<uint8_t const> zipData, std::filesystem::path const& outputPath) {
-        zip_error_t error;
-        zip_error_init(&error);
+    /// @brief entry from the central directory, used to plan the extraction before any data is read
+    struct ZipEntry {
+        zip_uint64_t index;
+        std::string name;
+        std::filesystem::path outputFilePath;
+        zip_uint64_t size;
+    };
 
-        auto zipSrc = zip_source_buffer_create(zipData.data(), zipData.size(), 0, &error);
-        if (zipSrc == nullptr) {
-            // could not create src buffer
-            zip_error_fini(&error);
-            return false;
+    static constexpr std::size_t ExtractBufferSize = 256 * 1024;
+
+    // the info is parsed from memory, anything bigger than this isn't a real info
+    static constexpr std::size_t MaxInfoSize = 16 * 1024 * 1024;
+
+    /// @brief called with every buffer of an entry after it was written, returning false stops the extraction
+    using ReadFunction = std::function<bool(std::span<uint8_t const>)>;
+
+    static std::size_t GetExtractionThreads() {
+        return std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, 4);
+    }
+
+    static bool WriteAll(int fd, char const* data, std::size_t size) {
+        while (size > 0) {
+            auto written = write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += written;
+            size -= written;
         }
+        return true;
+    }
 
-        auto zip = zip_open_from_source(zipSrc, ZIP_RDONLY, &error);
-        if (zip == nullptr) {
-            // was not a correct zip
-            zip_error_fini(&error);
-            zip_source_free(zipSrc);
-            zipSrc = nullptr;
+    static bool ExtractEntry(zip_t* zip, ZipEntry const& entry, std::span<char> buffer, ReadFunction const& onRead = nullptr) {
+        auto f = zip_fopen_index(zip, entry.index, ZIP_FL_UNCHANGED);
+        if (!f) return false;
+
+        int fd = open(entry.outputFilePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0664);
+        if (fd < 0) {
+            zip_fclose(f);
             return false;
         }
 
-        auto fileCount = zip_get_num_files(zip);
-        for (auto i = 0; i < fileCount; i++) {
-            auto name = zip_get_name(zip, i, ZIP_FL_ENC_GUESS);
-            if (!name) continue;
-            auto f = zip_fopen_index(zip, i, ZIP_FL_UNCHANGED);
-            if (!f) continue;
-            std::filesystem::path outputFilePath = outputPath / name;
-            std::filesystem::create_directories(outputFilePath.parent_path());
-
-            std::ofstream of(outputFilePath, std::ios::out | std::ios::binary);
-            char buf[256];
-            int64_t read = 0;
-            while ((read = zip_fread(f, buf, 256)) > 0) {
-                of.write(buf, read);
+        bool success = true;
+        // reserve the full size up front so the file doesn't have to grow with every write, filesystems without preallocation just grow it as usual
+        if (entry.size > 0) {
+            int error = posix_fallocate(fd, 0, entry.size);
+            if (error != 0 && error != EOPNOTSUPP && error != EINVAL) success = false;
+        }
+
+
+        zip_int64_t read = 0;
+        zip_uint64_t written = 0;
+        while (success && (read = zip_fread(f, buffer.data(), buffer.size())) > 0) {
+            if (!WriteAll(fd, buffer.data(), read)) {
+                success = false;
+                break;
+            }
+            written += read;
+            if (onRead && !onRead({(uint8_t const*)buffer.data(), (std::size_t)read})) {
+                success = false;
+                break;
             }
+        }
+        if (read < 0) success = false;
+        // don't leave the preallocated tail around if the entry was shorter than advertised
+        if (success && written != entry.size && ftruncate(fd, written) != 0) success = false;
 
-            zip_fclose(f);
-            of.close();
+        close(fd);
+        zip_fclose(f);
+        return success;
+    }
+
+    /// @brief gets the files that make up the map hash from the info.dat, in the order they are hashed
+    /// @return nullopt if the info is not in a format we know the hashing of
+    static std::optional<std::vector<std::string>> GetHashedFileNames(std::span<uint8_t const> infoData) {
+        rapidjson::Document doc;
+        doc.Parse((char const*)infoData.data(), infoData.size());
+        if (doc.HasParseError() || !doc.IsObject()) return std::nullopt;
+
+        // v4 infos don't have this, and we don't reproduce their hashing
+        auto setsItr = doc.FindMember("_difficultyBeatmapSets");
+        if (setsItr == doc.MemberEnd() || !setsItr->value.IsArray()) return std::nullopt;
+
+        std::vector<std::string> fileNames;
+        for (auto& set : setsItr->value.GetArray()) {
+            if (!set.IsObject()) continue;
+            auto diffsItr = set.FindMember("_difficultyBeatmaps");
+            if (diffsItr == set.MemberEnd() || !diffsItr->value.IsArray()) continue;
+
+            for (auto& diff : diffsItr->value.GetArray()) {
+                if (!diff.IsObject()) continue;
+                auto fileItr = diff.FindMember("_beatmapFilename");
+                if (fileItr == diff.MemberEnd() || !fileItr->value.IsString()) continue;
+                fileNames.emplace_back(fileItr->value.GetString(), fileItr->value.GetStringLength());
+            }
         }
 
+        return fileNames;
+    }
+
+    /// @brief feeds a file that was already extracted into the hash, for difficulties the info lists more than once
+    static bool HashFile(std::filesystem::path const& filePath, Sha1& sha, std::span<char> buffer) {
+        std::ifstream file(filePath, std::ios::in | std::ios::binary);
+        if (!file.is_open()) return false;
+        while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
+            sha.Update({(uint8_t const*)buffer.data(), (std::size_t)file.gcount()});
+        }
         return true;
     }
 
-    std::optional<std::vector<uint8_t>> GetData(std::string dataURL) {
-        return downloader.Get<WebUtils::DataResponse>({dataURL}).responseData;
+    /// @brief whether the entry is an info.dat, in the root of the zip or in a folder
+    static bool IsInfoFile(std::string_view name) {
+        auto slash = name.rfind('/');
+        auto fileName = slash == std::string_view::npos ? name : name.substr(slash + 1);
+        return std::ranges::equal(fileName, std::string_view("info.dat"), [](char a, char b){ return std::tolower(a) == b; });
+    }
+
+    /// @brief everything an extraction put on disk, so a failed one can be undone
+    struct ExtractedPaths {
+        std::vector<std::filesystem::path> files;
+        // outermost first
+        std::vector<std::filesystem::path> directories;
+    };
+
+    /// @brief creates the directory and its parents, remembering the ones that didn't exist yet
+    static void CreateDirectories(std::filesystem::path const& directory, ExtractedPaths& extracted) {
+        std::error_code ec;
+        std::vector<std::filesystem::path> missing;
+        for (auto path = directory; !path.empty() && !std::filesystem::exists(path, ec); path = path.parent_path()) missing.push_back(path);
+        if (missing.empty()) return;
+        std::filesystem::create_directories(directory, ec);
+        extracted.directories.insert(extracted.directories.end(), missing.rbegin(), missing.rend());
+    }
+
+    /// @brief extracts every entry of the archive, openArchive is called once per worker because a libzip archive can't be read from multiple threads
+    static bool ExtractArchive(std::function<zip_t*()> const& openArchive, std::filesystem::path const& outputPath, std::string_view expectedHash, ExtractedPaths& extracted) {
+        auto zip = openArchive();
+        if (!zip) return false;
+
+        auto normalOutputPath = outputPath.lexically_normal();
+        std::vector<ZipEntry> entries;
+        auto entryCount = zip_get_num_entries(zip, 0);
+        for (zip_int64_t i = 0; i < entryCount; i++) {
+            zip_stat_t stat;
+            zip_stat_init(&stat);
+            if (zip_stat_index(zip, i, ZIP_FL_ENC_GUESS, &stat) != 0) continue;
+            if (!(stat.valid & ZIP_STAT_NAME) || !stat.name) continue;
+
+            std::string_view name(stat.name);
+            auto outputFilePath = (outputPath / name).lexically_normal();
+            // entries like ../file would end up outside of the output dir
+            auto relativePath = outputFilePath.lexically_relative(normalOutputPath);
+            if (relativePath.empty() || *relativePath.begin() == "..") continue;
+
+            if (name.ends_with('/')) {
+                CreateDirectories(outputFilePath, extracted);
+                continue;
+            }
+
+            // directories are made up front so workers never race on them
+            CreateDirectories(outputFilePath.parent_path(), extracted);
+            extracted.files.push_back(outputFilePath);
+            entries.push_back({static_cast<zip_uint64_t>(i), std::string(name), std::move(outputFilePath), (stat.valid & ZIP_STAT_SIZE) ? stat.size : 0});
+        }
+
+        // biggest entries first, so the audio file is never the one thing left for a single worker at the end
+        std::ranges::sort(entries, std::ranges::greater{}, &ZipEntry::size);
+
+        // the hash covers the info and the difficulty files it lists, so the info is extracted first to know which entries those are
+        std::vector<uint8_t> infoData;
+        std::optional<std::vector<std::string>> hashedFileNames;
+        // the hashed entries, and the order they are hashed in as indices into them
+        std::vector<ZipEntry> hashedEntries;
+        std::vector<std::size_t> hashOrder;
+        auto buffer = std::make_unique<char[]>(ExtractBufferSize);
+        if (!expectedHash.empty()) {
+            // maps are often zipped with their folder, the shallowest info is the map and the folder it's in the root the difficulties are listed relative to
+            auto infoItr = entries.end();
+            for (auto itr = entries.begin(); itr != entries.end(); itr++) {
+                if (!IsInfoFile(itr->name)) continue;
+                if (infoItr == entries.end() || std::ranges::count(itr->name, '/') < std::ranges::count(infoItr->name, '/')) infoItr = itr;
+            }
+            if (infoItr == entries.end()) {
+                zip_discard(zip);
+                return false;
+            }
+
+            auto infoEntry = std::move(*infoItr);
+            entries.erase(infoItr);
+            auto mapRoot = infoEntry.name.substr(0, infoEntry.name.rfind('/') + 1);
+            bool extracted = ExtractEntry(zip, infoEntry, {buffer.get(), ExtractBufferSize}, [&infoData](std::span<uint8_t const> read) {
+                if (infoData.size() + read.size() > MaxInfoSize) return false;
+                infoData.insert(infoData.end(), read.begin(), read.end());
+                return true;
+            });
+            if (!extracted) {
+                zip_discard(zip);
+                return false;
+            }
+
+            hashedFileNames = GetHashedFileNames(infoData);
+            if (hashedFileNames.has_value()) {
+                for (auto const& listedName : *hashedFileNames) {
+                    auto fileName = mapRoot + listedName;
+                    auto hashedItr = std::ranges::find(hashedEntries, fileName, &ZipEntry::name);
+                    if (hashedItr != hashedEntries.end()) {
+                        hashOrder.emplace_back(hashedItr - hashedEntries.begin());
+                        continue;
+                    }
+
+                    auto entryItr = std::ranges::find(entries, fileName, &ZipEntry::name);
+                    // a listed difficulty that isn't in the zip can never match
+                    if (entryItr == entries.end()) {
+                        zip_discard(zip);
+                        return false;
+                    }
+                    hashOrder.emplace_back(hashedEntries.size());
+                    hashedEntries.emplace_back(std::move(*entryItr));
+                    entries.erase(entryItr);
+                }
+            }
+        }
+
+        // the workers take everything that isn't hashed, like the audio and images
+        std::atomic_size_t next = 0;
+        std::atomic_bool success = true;
+        auto extractEntries = [&entries, &next, &success](zip_t* workerZip, std::span<char> workerBuffer) {
+            for (auto idx = next++; idx < entries.size() && success; idx = next++) {
+                if (!ExtractEntry(workerZip, entries[idx], workerBuffer)) success = false;
+            }
+        };
+
+        std::vector<std::thread> workers;
+        auto workerCount = std::min(GetExtractionThreads(), entries.size());
+        // the calling thread is busy with the hashed entries first, so it doesn't count as a worker then
+        for (std::size_t i = hashOrder.empty() ? 1 : 0; i < workerCount; i++) {
+            workers.emplace_back([&openArchive, &extractEntries]() {
+                auto workerZip = openArchive();
+                // the other workers will pick up the entries this one can't
+                if (!workerZip) return;
+                auto workerBuffer = std::make_unique<char[]>(ExtractBufferSize);
+                extractEntries(workerZip, {workerBuffer.get(), ExtractBufferSize});
+                zip_discard(workerZip);
+            });
+        }
+
+        // hashed entries are extracted in hash order on this thread, so every buffer goes into the hash as it's read instead of being kept around
+        if (hashedFileNames.has_value()) {
+            Sha1 sha;
+            sha.Update(infoData);
+            std::vector<bool> extracted(hashedEntries.size(), false);
+            for (auto idx : hashOrder) {
+                if (!success) break;
+                auto const& entry = hashedEntries[idx];
+                bool hashed = extracted[idx] ? HashFile(entry.outputFilePath, sha, {buffer.get(), ExtractBufferSize}) : ExtractEntry(zip, entry, {buffer.get(), ExtractBufferSize}, [&sha](std::span<uint8_t const> read) {
+                    sha.Update(read);
+                    return true;
+                });
+                extracted[idx] = true;
+                if (!hashed) success = false;
+            }
+
+            if (success) {
+                auto hash = sha.HexDigest();
+                // no point in extracting the rest of a map that's going to be thrown away
+                if (!std::ranges::equal(hash, expectedHash, [](char a, char b){ return a == std::tolower(b); })) success = false;
+            }
+        }
+
+        // then it helps with whatever is left
+        extractEntries(zip, {buffer.get(), ExtractBufferSize});
+        for (auto& worker : workers) worker.join();
+
+        zip_discard(zip);
+        if (!success) return false;
+        if (!expectedHash.empty() && !hashedFileNames.has_value()) {
+            // nothing to compare against, so we trust the download
+            WARNING("Can't verify the hash of {}, unknown info format", outputPath.string());
+        }
+        return true;
+    }
+
+    /// @brief extracts the archive, and removes whatever it got to write if it fails so no partial map is left in outputPath
+    static bool ExtractArchive(std::function<zip_t*()> const& openArchive, std::filesystem::path const& outputPath, std::string_view expectedHash) {
+        ExtractedPaths extracted;
+        if (ExtractArchive(openArchive, outputPath, expectedHash, extracted)) return true;
+
+        std::error_code ec;
+        for (auto const& file : extracted.files) std::filesystem::remove(file, ec);
+        // the directories only hold what was extracted into them, innermost go first
+        for (auto itr = extracted.directories.rbegin(); itr != extracted.directories.rend(); itr++) std::filesystem::remove_all(*itr, ec);
+        return false;
+    }
+
+    bool ExtractAll(std::span<uint8_t const> zipData, std::filesystem::path const& outputPath, std::string_view expectedHash) {
+        return ExtractArchive([zipData]() -> zip_t* {
+            zip_error_t error;
+            zip_error_init(&error);
+
+            auto zipSrc = zip_source_buffer_create(zipData.data(), zipData.size(), 0, &error);
+            if (zipSrc == nullptr) {
+                // could not create src buffer
+                zip_error_fini(&error);
+                return nullptr;
+            }
+
+            auto zip = zip_open_from_source(zipSrc, ZIP_RDONLY, &error);
+            // was not a correct zip, on success the archive owns the source
+            if (zip == nullptr) zip_source_free(zipSrc);
+
+            zip_error_fini(&error);
+            return zip;
+        }, outputPath, expectedHash);
+    }
+
+    bool ExtractAll(std::filesystem::path const& zipPath, std::filesystem::path const& outputPath, std::string_view expectedHash) {
+        return ExtractArchive([&zipPath]() -> zip_t* {
+            int errorCode = 0;
+            // nullptr if the file did not exist or was not a correct zip
+            return zip_open(zipPath.c_str(), ZIP_RDONLY, &errorCode);
+        }, outputPath, expectedHash);
+    }
+
+    bool MoveDirectory(std::filesystem::path const& from, std::filesystem::path const& to) {
+        std::error_code ec;
+        std::filesystem::create_directories(to.parent_path(), ec);
+
+        // whatever is at to is moved aside rather than deleted, so it can be put back if the move fails
+        auto backup = to;
+        backup += ".old";
+        std::filesystem::remove_all(backup, ec);
+        bool hadBackup = false;
+        if (std::filesystem::exists(to, ec)) {
+            std::filesystem::rename(to, backup, ec);
+            if (ec) {
+                ERROR("Could not move {} aside to replace it: {}", to.string(), ec.message());
+                return false;
+            }
+            hadBackup = true;
+        }
+
+        auto restore = [&]() {
+            std::error_code restoreEc;
+            std::filesystem::remove_all(to, restoreEc);
+            if (hadBackup) std::filesystem::rename(backup, to, restoreEc);
+        };
+
+        std::filesystem::rename(from, to, ec);
+        if (ec) {
+            // different filesystems can't rename into each other
+            ec.clear();
+            std::filesystem::copy(from, to, std::filesystem::copy_options::recursive, ec);
+            if (ec) {
+                ERROR("Could not move {} to {}: {}", from.string(), to.string(), ec.message());
+                restore();
+                return false;
+            }
+            std::filesystem::remove_all(from, ec);
+        }
+
+        if (hadBackup) std::filesystem::remove_all(backup, ec);
+        return true;
+    }
+
+    // the maps are unordered so they get sorted first
+    std::string GetRequestKey(WebUtils::URLOptions const& urlOptions) {
+        std::map<std::string, std::string> queries(urlOptions.queries.begin(), urlOptions.queries.end());
+        std::map<std::string, std::string> headers(urlOptions.headers.begin(), urlOptions.headers.end());
+
+        std::string key = urlOptions.url;
+        key += urlOptions.noEscape ? "\n1" : "\n0";
+        for (auto const& [k, v] : queries) key += fmt::format("\nq:{}={}", k, v);
+        for (auto const& [k, v] : headers) key += fmt::format("\nh:{}={}", k, v);
+        return key;
+    }
+
+    std::optional<std::vector<uint8_t>> GetData(std::string dataURL, std::stop_token stopToken) {
+        return API::FetchRaw(WebUtils::URLOptions(dataURL), nullptr, stopToken)->data;
+    }
+
+    std::optional<std::vector<uint8_t>> GetAsset(std::string assetURL, std::string_view hash, std::stop_token stopToken) {
+        return API::FetchAsset(WebUtils::URLOptions(assetURL), hash, nullptr, stopToken)->data;
     }
 }
@@ -0,0 +1,175 @@
+#include "ZipStore.hpp"
+#include "BeatSaver.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace BeatSaver::ZipStore {
+    // the store dir is shared by every download thread, eviction and adding have to agree on what's in it
+    static std::mutex storeMutex;
+    // how many found zips are still being read per hash, those aren't evicted
+    static std::unordered_map<std::string, int> pinned;
+
+    static std::filesystem::path GetStorePath() {
+        return API::GetDataPath() / "store";
+    }
+
+    /// @brief lowercases the hash, nullopt if it isn't a sha1 hex string so it can't be used to escape the store dir
+    static std::optional<std::string> NormalizeHash(std::string_view hash) {
+        if (hash.size() != 40) return std::nullopt;
+
+        std::string normalized(hash);
+        for (auto& c : normalized) {
+            if (!std::isxdigit((unsigned char)c)) return std::nullopt;
+            c = std::tolower((unsigned char)c);
+        }
+        return normalized;
+    }
+
+    static std::filesystem::path GetZipPath(std::string const& hash) {
+        return GetStorePath() / fmt::format("{}.zip", hash);
+    }
+
+    /// @brief deletes the least recently used zips until the store fits the budget again, expects storeMutex to be held
+    static void Evict(std::uintmax_t budget) {
+        struct StoredZip {
+            std::filesystem::path path;
+            std::uintmax_t size;
+            std::filesystem::file_time_type lastUsed;
+        };
+
+        std::error_code ec;
+        std::vector<StoredZip> zips;
+        std::uintmax_t totalSize = 0;
+        for (auto const& entry : std::filesystem::directory_iterator(GetStorePath(), ec)) {
+            if (!entry.is_regular_file(ec) || entry.path().extension() != ".zip") continue;
+            if (pinned.contains(entry.path().stem().string())) continue;
+            auto size = entry.file_size(ec);
+            if (ec) continue;
+            zips.push_back({entry.path(), size, entry.last_write_time(ec)});
+            totalSize += size;
+        }
+
+        if (totalSize <= budget) return;
+
+        std::ranges::sort(zips, {}, &StoredZip::lastUsed);
+        for (auto const& zip : zips) {
+            if (totalSize <= budget) break;
+            DEBUG("Evicting {} from the zip store", zip.path.filename().string());
+            if (std::filesystem::remove(zip.path, ec)) totalSize -= zip.size;
+        }
+    }
+
+    StoredZip Find(std::string_view hash) {
+        if (API::GetZipStoreBudget() == 0) return nullptr;
+        auto normalized = NormalizeHash(hash);
+        if (!normalized.has_value()) return nullptr;
+
+        std::unique_lock lock(storeMutex);
+        auto zipPath = GetZipPath(normalized.value());
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(zipPath, ec)) return nullptr;
+
+        // the modification time doubles as the last use for eviction
+        std::filesystem::last_write_time(zipPath, std::filesystem::file_time_type::clock::now(), ec);
+
+        pinned[normalized.value()]++;
+        return StoredZip(new std::filesystem::path(zipPath), [hash = normalized.value()](std::filesystem::path const* path) {
+            {
+                std::unique_lock lock(storeMutex);
+                if (--pinned[hash] == 0) pinned.erase(hash);
+            }
+            delete path;
+        });
+    }
+
+    bool Add(std::string_view hash, std::filesystem::path const& zipPath) {
+        auto budget = API::GetZipStoreBudget();
+        if (budget == 0) return false;
+        auto normalized = NormalizeHash(hash);
+        if (!normalized.has_value()) return false;
+
+        std::error_code ec;
+        auto size = std::filesystem::file_size(zipPath, ec);
+        if (ec || size > budget) return false;
+
+        std::unique_lock lock(storeMutex);
+        auto storedPath = GetZipPath(normalized.value());
+        std::filesystem::create_directories(storedPath.parent_path(), ec);
+        std::filesystem::rename(zipPath, storedPath, ec);
+        if (ec) {
+            // different filesystems can't rename into each other
+            ec.clear();
+            std::filesystem::copy_file(zipPath, storedPath, std::filesystem::copy_options::overwrite_existing, ec);
+            if (ec) {
+                WARNING("Could not add {} to the zip store: {}", normalized.value(), ec.message());
+                std::filesystem::remove(storedPath, ec);
+                return false;
+            }
+            std::filesystem::remove(zipPath, ec);
+        }
+        std::filesystem::last_write_time(storedPath, std::filesystem::file_time_type::clock::now(), ec);
+
+        Evict(budget);
+        return true;
+    }
+
+    bool Add(std::string_view hash, std::span<uint8_t const> zipData) {
+        auto budget = API::GetZipStoreBudget();
+        if (budget == 0 || zipData.size() > budget) return false;
+        auto normalized = NormalizeHash(hash);
+        if (!normalized.has_value()) return false;
+
+        std::unique_lock lock(storeMutex);
+        auto storedPath = GetZipPath(normalized.value());
+        // written next to the final name first, so a half written zip never gets found
+        auto tempPath = storedPath;
+        tempPath += ".tmp";
+
+        std::error_code ec;
+        std::filesystem::create_directories(storedPath.parent_path(), ec);
+        {
+            std::ofstream of(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            of.write((char const*)zipData.data(), zipData.size());
+            if (!of.good()) {
+                WARNING("Could not add {} to the zip store", normalized.value());
+                of.close();
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+        std::filesystem::rename(tempPath, storedPath, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        Evict(budget);
+        return true;
+    }
+
+    void Remove(std::string_view hash) {
+        auto normalized = NormalizeHash(hash);
+        if (!normalized.has_value()) return;
+
+        std::unique_lock lock(storeMutex);
+        std::error_code ec;
+        std::filesystem::remove(GetZipPath(normalized.value()), ec);
+    }
+
+    std::optional<std::string> HashFromURL(std::string_view url) {
+        auto query = url.find_first_of("?#");
+        if (query != std::string_view::npos) url = url.substr(0, query);
+
+        auto slash = url.rfind('/');
+        auto fileName = slash == std::string_view::npos ? url : url.substr(slash + 1);
+        if (!fileName.ends_with(".zip")) return std::nullopt;
+
+        return NormalizeHash(fileName.substr(0, fileName.size() - 4));
+    }
+}